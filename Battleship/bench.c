@@ -0,0 +1,312 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "map.h"
+
+#include "game.h"
+#include "snapshot.h"
+#include "scheduler.h"
+#include "options.h"
+#include "random.h"
+#include "utils.h"
+#include "io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/*
+    Microbenchmarks of the hot paths of the maps, over the backends and the map sizes, run with 'make bench'.
+    Options:
+        --backends <list>   backends, separated by commas (default "quadtree,matrix,bitboard,linear,adaptive")
+        --sizes <list>      map sizes, separated by commas (default "20,40,64,256,1024,4096")
+        --ops <n>           operations of each benchmark of single cells (default 200000)
+        --seed <n>          seed of the cells chosen (default 1)
+    Prints one line per benchmark, as CSV (with a header):
+        backend,size,benchmark,ops,ns_per_op,allocs_per_op,bytes_per_op,peak_rss_kb
+    The allocations (malloc, calloc, realloc and posix_memalign) are counted by wrapping them at link time (see the Makefile).
+    Each backend and size runs on its own process, so peak_rss_kb is the peak of that process till the end of the benchmark.
+    The benchmark "setup" is a whole random setup of a game (as a headless game), so its size is the random size of the setup (21 to 40),
+    and "snapshot" is a snapshot of one of those games, with half its cells attacked, saved and restored (see snapshot.h).
+*/
+
+// Counters of the allocations, incremented by the wrappers below
+static long nr_allocs, nr_bytes;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+int __real_posix_memalign(void** p_pointer, size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+    nr_allocs++;
+    nr_bytes += size;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    nr_allocs++;
+    nr_bytes += count * size;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size)
+{
+    nr_allocs++;
+    nr_bytes += size;
+    return __real_realloc(pointer, size);
+}
+
+int __wrap_posix_memalign(void** p_pointer, size_t alignment, size_t size)
+{
+    nr_allocs++;
+    nr_bytes += size;
+    return __real_posix_memalign(p_pointer, alignment, size);
+}
+
+// A benchmark being measured: when it started and the allocations till then
+typedef struct Measure
+{
+    const char* name;
+    double start;
+    long allocs, bytes;
+} Measure;
+
+static void startMeasure(Measure* measure, const char* name)
+{
+    measure->name = name;
+    measure->allocs = nr_allocs;
+    measure->bytes = nr_bytes;
+    measure->start = now_Scheduler();
+}
+
+// Prints the line of the benchmark, with 'ops' operations done since it started
+static void endMeasure(Measure* measure, const char* size, long ops)
+{
+    double seconds = now_Scheduler() - measure->start;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("%s,%s,%s,%ld,%.1f,%.3f,%.1f,%ld\n", getBackend_Map(), size, measure->name, ops, 1e9 * seconds / ops,
+           (double) (nr_allocs - measure->allocs) / ops, (double) (nr_bytes - measure->bytes) / ops, usage.ru_maxrss);
+}
+
+// Sum of what was read from the maps, so reading isn't optimized away
+static volatile long checksum;
+
+// Runs all the benchmarks of the current backend, with maps of size * size
+static void benchSize(int size, long nr_ops, uint64_t seed)
+{
+    char size_name[16];
+    snprintf(size_name, sizeof(size_name), "%d", size);
+    Measure measure;
+
+    // The cells of the single cell benchmarks are chosen before, so the generator isn't measured
+    Random random;
+    seed_Random(&random, seed);
+    int* xs = (int*) malloc(nr_ops * sizeof(int));
+    int* ys = (int*) malloc(nr_ops * sizeof(int));
+    if(xs == NULL || ys == NULL)
+        prompt_IO(ERROR_IO, "bench.c, benchSize(): malloc failed");
+    for(long i = 0; i < nr_ops; i++) {
+        xs[i] = range_Random(&random, size);
+        ys[i] = range_Random(&random, size);
+    }
+
+    // Pieces on a grid, one per 5x5 square (so they never overlap), cycling through the types and rotations
+    int per_row = size / 5;
+    int nr_pieces = per_row * per_row < MAX_PIECES_CELL ? per_row * per_row : MAX_PIECES_CELL;
+    Piece* pieces = (Piece*) malloc((nr_pieces > 0 ? nr_pieces : 1) * sizeof(Piece));
+    if(pieces == NULL)
+        prompt_IO(ERROR_IO, "bench.c, benchSize(): malloc of the pieces failed");
+    for(int i = 0; i < nr_pieces; i++)
+        update_Piece(&pieces[i], getType_Utils(i % 5), 5 * (i / per_row) + 2, 5 * (i % per_row) + 2, 90 * ((i / 5) % 4));
+
+    startMeasure(&measure, "new_Map");
+    Map* map = new_Map(size, pieces);
+    endMeasure(&measure, size_name, 1);
+
+    startMeasure(&measure, "addPiece_Map");
+    for(int i = 0; i < nr_pieces; i++)
+        if(addPiece_Map(map, &pieces[i]) != 0)
+            prompt_IO(ERROR_IO, "bench.c, benchSize(): piece not added");
+    endMeasure(&measure, size_name, nr_pieces > 0 ? nr_pieces : 1);
+
+    startMeasure(&measure, "getPieceStatus_Map");
+    long sum = 0;
+    for(long i = 0; i < nr_ops; i++)
+        sum += getPieceStatus_Map(map, xs[i], ys[i]);
+    endMeasure(&measure, size_name, nr_ops);
+
+    startMeasure(&measure, "registerShot_Map");
+    for(long i = 0; i < nr_ops; i++)
+        registerShot_Map(map, xs[i], ys[i], 1 + i % 6);
+    endMeasure(&measure, size_name, nr_ops);
+
+    // The same shots, with one handle (see map.h) per cell, also reading the statuses through it
+    startMeasure(&measure, "registerShotCell_Map");
+    for(long i = 0; i < nr_ops; i++) {
+        CellHandle cell = findOrInsertCell_Map(map, xs[i], ys[i]);
+        sum += getPieceStatusCell_Map(&cell) + getShotStatusCell_Map(&cell);
+        registerShotCell_Map(&cell, 1 + i % 6);
+    }
+    endMeasure(&measure, size_name, nr_ops);
+
+    startMeasure(&measure, "getShotStatus_Map");
+    for(long i = 0; i < nr_ops; i++)
+        sum += getShotStatus_Map(map, xs[i], ys[i]);
+    endMeasure(&measure, size_name, nr_ops);
+
+    // The renderings export the whole map and format it, as PIECES_MAP_IO and SHOTS_MAP_IO, into a buffer (not printed)
+    long nr_frames = 4000000L / ((long) size * size);
+    if(nr_frames < 1)
+        nr_frames = 1;
+    if(nr_frames > 1000)
+        nr_frames = 1000;
+    byte* rows = (byte*) malloc((size_t) size * size);
+    char* buffer = (char*) malloc((size_t) 2 * size * size);
+    if(rows == NULL || buffer == NULL)
+        prompt_IO(ERROR_IO, "bench.c, benchSize(): malloc of the buffers failed");
+
+    for(int pieces = 1; pieces >= 0; pieces--) {
+        const char* chars = pieces ? ".IPTXZX" : ".MIPTXZ";
+        startMeasure(&measure, pieces ? "render_pieces" : "render_shots");
+        for(long frame = 0; frame < nr_frames; frame++) {
+            exportRows_Map(map, rows, pieces);
+            char* p = buffer;
+            for(byte* row = rows; row < rows + (long) size * size; row += size) {
+                for(int y = 0; y < size; y++) {
+                    *p++ = chars[row[y]];
+                    *p++ = ' ';
+                }
+                p[-1] = '\n';
+            }
+            sum += buffer[frame % size];
+        }
+        endMeasure(&measure, size_name, nr_frames);
+    }
+
+    startMeasure(&measure, "registerAttack_Map");
+    for(long i = 0; i < nr_ops; i++)
+        sum += registerAttack_Map(map, xs[i], ys[i]);
+    endMeasure(&measure, size_name, nr_ops);
+
+    startMeasure(&measure, "free_Map");
+    free_Map(map);
+    endMeasure(&measure, size_name, 1);
+
+    checksum += sum;
+    free(rows);
+    free(buffer);
+    free(pieces);
+    free(xs);
+    free(ys);
+}
+
+// Runs the benchmark of the random setup of the current backend: 'nr_games' headless games set up and freed
+static void benchSetup(int nr_games, uint64_t seed)
+{
+    Measure measure;
+    startMeasure(&measure, "setup");
+    for(int i = 0; i < nr_games; i++)
+        free_Game(newHeadless_Game(seed + i));
+    endMeasure(&measure, "21-40", nr_games);
+}
+
+// Runs the benchmark of the snapshots of the current backend: one headless game, with half its cells attacked, saved and restored 'nr_copies' times
+static void benchSnapshot(int nr_copies, uint64_t seed)
+{
+    Game* game = newHeadless_Game(seed);
+    int size = game->players[0]->map->size;
+    for(int x = 0; x < size; x++)
+        for(int y = x % 2; y < size; y += 2) {
+            attack_Game(game, x, y);
+            attack_Game(game, x, y);
+        }
+
+    size_t blob_size = size_Snapshot(game);
+    void* blob = malloc(blob_size);
+    if(blob == NULL)
+        prompt_IO(ERROR_IO, "bench.c, benchSnapshot(): malloc failed");
+
+    char size_name[16];
+    snprintf(size_name, sizeof(size_name), "%d", size);
+    Measure measure;
+    startMeasure(&measure, "snapshot");
+    for(int i = 0; i < nr_copies; i++) {
+        save_Snapshot(game, blob);
+        Game* copy = restore_Snapshot(blob, blob_size);
+        if(copy == NULL)
+            prompt_IO(ERROR_IO, "bench.c, benchSnapshot(): snapshot not restored");
+        free_Game(copy);
+    }
+    endMeasure(&measure, size_name, nr_copies);
+
+    free(blob);
+    free_Game(game);
+}
+
+// Runs 'bench' on a new process (so it has its own peak RSS), and waits for it
+static void runProcess(const char* backend, int size, long nr_ops, uint64_t seed)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if(pid < 0)
+        prompt_IO(ERROR_IO, "bench.c, runProcess(): fork failed");
+
+    if(pid == 0) {
+        setBackend_Map(backend);
+        if(size > 0)
+            benchSize(size, nr_ops, seed);
+        else {
+            benchSetup(200, seed);
+            benchSnapshot(200, seed);
+        }
+        fflush(stdout);
+        _exit(0);
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        fprintf(stderr, "[System] The benchmark of %s, size %d, failed.\n", backend, size);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* backends = get_Options(argc, argv, "backends", NULL);
+    const char* sizes = get_Options(argc, argv, "sizes", NULL);
+    long nr_ops = (long) getNumber_Options(argc, argv, "ops", NULL, 200000);
+    uint64_t seed = getNumber_Options(argc, argv, "seed", NULL, 1);
+    if(backends == NULL)
+        backends = "quadtree,matrix,bitboard,linear,adaptive";
+    if(sizes == NULL)
+        sizes = "20,40,64,256,1024,4096";
+    if(nr_ops <= 0)
+        prompt_IO(ERROR_IO, "[System] The number of operations must be positive.");
+
+    printf("backend,size,benchmark,ops,ns_per_op,allocs_per_op,bytes_per_op,peak_rss_kb\n");
+
+    char backends_copy[256];
+    snprintf(backends_copy, sizeof(backends_copy), "%s", backends);
+    for(char* backend = strtok(backends_copy, ","); backend != NULL; backend = strtok(NULL, ",")) {
+        if(!setBackend_Map(backend))
+            prompt_IO(ERROR_IO, "[System] Unknown map. The maps are 'quadtree', 'matrix', 'bitboard', 'linear' and 'adaptive'.");
+
+        // strtok can't go through both lists at once, so the sizes are read with strtol
+        for(const char* p = sizes; *p != '\0'; ) {
+            char* end;
+            long size = strtol(p, &end, 10);
+            if(end == p || size < 5 || size > 65536)
+                prompt_IO(ERROR_IO, "[System] The sizes must be between 5 and 65536, separated by commas.");
+            runProcess(backend, (int) size, nr_ops, seed);
+            p = (*end == ',') ? end + 1 : end;
+        }
+        runProcess(backend, 0, nr_ops, seed);
+    }
+
+    return 0;
+}
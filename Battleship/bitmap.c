@@ -1,127 +1,70 @@
 #include "bitmap.h"
 
-#include <stdlib.h>
+#include "utils.h"
 #include "io.h"
 
 /*
- Available formats of bitmaps. 
+ Available formats of bitmaps, already rotated.
  They are stored compressed, through an int, which the corresponding binary sequence, corresponds to the values of the bitmap, 
  with the position (4,4) of the bitmap being the less significant digit of the number 
  and the position (0,0) the eighth most significant digit of the number.
  The most 7 significant digits aren't necessary, so they aren't used.
 
- The reason to store them compressed is memory: 4 bytes is less 25 bytes, for more than a factor of 6.
- To store the five types of bitmaps we would need 5 * 25 = 125 bytes and, in this way, we only need 5 * 4 = 20 bytes. 
+ Each line has a type (I, P, T, X and Z, respectively) and each column a rotation, clockwise (0, 90, 180 and 270 degrees, respectively).
+ The rotations of a format were made by the rotation of the positions (x,y) of the bitmap:
+ (x,y) goes to (y, 4 - x), for 90 degrees, to (4 - x, 4 - y), for 180 degrees and to (4 - y, x), for 270 degrees.
 */
-static int getCompressedType(char type)
-{
-  switch(type) {
-    case 'I': return 31744;
-    case 'P': return 202880;
-    case 'T': return 462976;
-    case 'X': return 332096;
-    case 'Z': return 397504;
-    // Case an invalid type is used, notify and abort execution
-    default: prompt_IO(ERROR_IO, "bitmap.c, getCompressedType(): invalid type");
-  }
-  // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
-  return 0;
-}
-
-/* 
-  Function that stores in an array (field) the binary sequence of an int (compressed_form),
-  The less significant digits are in the higher positions of the array, with the position 24 of the array (the last one), being the less significant digit.
-  Note than an int usually as 32 bits and the array only has 25: the 7 most significant digits aren't stored.
-*/
-static void decompress(int compressed_form, byte field[25])
-{
-  for(int p = 24; p >= 0; p--) {
-    field[p] = compressed_form % 2;
-    compressed_form /= 2;
-  }
-}
+#define MASK_I0   31744
+#define MASK_I90  4329604
+#define MASK_P0   202880
+#define MASK_P90  14528
+#define MASK_P180 143744
+#define MASK_P270 407552
+#define MASK_T0   462976
+#define MASK_T90  79936
+#define MASK_T180 135616
+#define MASK_T270 276736
+#define MASK_X    332096
+#define MASK_Z0   397504
+#define MASK_Z90  80128
 
 /*
-  We have an array representing the square bitmap.
-  This functions return the position of a (x,y) in the array when rotated by n degrees, clockwise.
-
-  Function are named 'rotateN', where 'N' is the corresponding degree of the rotation.
+ The formats decompressed at compile time, as masks where the bit x * 5 + y is the position (x,y) of the bitmap:
+ the bit p of the mask is the digit (24 - p) of the compressed format (the inverse order of its digits).
 */
-static int rotate0(int x, int y)
-{
-  return x * 5 + y;
-}
-
-static int rotate90(int x, int y)
-{
-  return 20 + x - (5 * y);
-}
-
-static int rotate180(int x, int y)
-{
-  return 24 - (5 * x) - y;
-}
-
-static int rotate270(int x, int y)
-{
-  return 4 - x + (5 * y);
-}
-
-
-BitMap* new_BitMap() 
-{
-  BitMap* bm = (BitMap*) malloc(sizeof(BitMap));
-
-  // Case malloc failed, print that malloc failed and abort execution 
-  if(bm == NULL)
-    prompt_IO(ERROR_IO, "bitmap.c, new_BitMap(): malloc failed");
-
-  return bm;
-}
-
-void update_BitMap(BitMap* bm, char type, int n)
+#define DIGIT(m, d) (((m) >> (d)) & 1)
+#define AT(m, p) (DIGIT(m, 24 - (p)) << (p))
+#define POSITIONS(m) ((uint32_t) (AT(m, 0)  | AT(m, 1)  | AT(m, 2)  | AT(m, 3)  | AT(m, 4)  | \
+                                  AT(m, 5)  | AT(m, 6)  | AT(m, 7)  | AT(m, 8)  | AT(m, 9)  | \
+                                  AT(m, 10) | AT(m, 11) | AT(m, 12) | AT(m, 13) | AT(m, 14) | \
+                                  AT(m, 15) | AT(m, 16) | AT(m, 17) | AT(m, 18) | AT(m, 19) | \
+                                  AT(m, 20) | AT(m, 21) | AT(m, 22) | AT(m, 23) | AT(m, 24)))
+
+static const uint32_t masks[5][4] = {
+  { POSITIONS(MASK_I0), POSITIONS(MASK_I90), POSITIONS(MASK_I0),   POSITIONS(MASK_I90) },
+  { POSITIONS(MASK_P0), POSITIONS(MASK_P90), POSITIONS(MASK_P180), POSITIONS(MASK_P270) },
+  { POSITIONS(MASK_T0), POSITIONS(MASK_T90), POSITIONS(MASK_T180), POSITIONS(MASK_T270) },
+  { POSITIONS(MASK_X),  POSITIONS(MASK_X),   POSITIONS(MASK_X),    POSITIONS(MASK_X) },
+  { POSITIONS(MASK_Z0), POSITIONS(MASK_Z90), POSITIONS(MASK_Z0),   POSITIONS(MASK_Z90) }
+};
+
+// Returns the column of the rotation in the table of formats
+static int rotationIndex(int n)
 {
-  /* 
-    Get the function to the rotation, acordingly to the the degree 'n'.
-    It's better to choose and store the function to be used first, than, in the loop, where the bitmap is updated, choose, every iteration, what function to use.
-  */
-  int (*rotateFunction)(int, int);
   switch(n) {
-      case 0: rotateFunction = rotate0; break;
-      case 90: rotateFunction = rotate90; break;
-      case 180: rotateFunction = rotate180; break;
-      case 270: rotateFunction = rotate270; break;
-      // Case it's an invalid rotation, notify and abort execution.
-      default: prompt_IO(ERROR_IO, "bitmap.c, update_BitMap(): invalid rotation");
+    case 0: return 0;
+    case 90: return 1;
+    case 180: return 2;
+    case 270: return 3;
+    // Case it's an invalid rotation, notify and abort execution.
+    default: prompt_IO(ERROR_IO, "bitmap.c, rotationIndex(): invalid rotation");
   }
-
-  // Get the compressed format of the type
-  int compressed_form = getCompressedType(type);
-
-  // Decompression of the compressed format of the type to an array field
-  byte field[25];
-  decompress(compressed_form, field);
-
-  // Updating the field of the bitmap.
-  for(int x = 0; x < 5; x++)
-    for(int y = 0; y < 5; y++)
-      // The position (x,y) of the bitmap is set to the position given by the respective rotating function of the field decompressed.
-      bm->field[x * 5 + y] = field[rotateFunction(x, y)];
+  // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
+  return 0;
 }
 
-// The position (x,y) is the position x * 5  + y in the array
-void setValue_BitMap(BitMap* bm, int x, int y, byte b)
-{
-  bm->field[x * 5 + y] = b;
-}
 
-// The position (x,y) is the position x * 5  + y in the array
-byte getValue_BitMap(BitMap* bm, int x, int y) 
+uint32_t getMask_BitMap(char type, int n)
 {
-  return bm->field[x * 5 + y];
+  return masks[getTypeIndex_Utils(type)][rotationIndex(n)];
 }
-
-void free_BitMap(BitMap* bm) 
-{
-  free(bm);
-}
\ No newline at end of file
@@ -1,8 +1,8 @@
 /*
   bitmap.h
-  Representation of a bitmap 5x5.
+  Formats of the pieces, on a bitmap 5x5.
   
-  Each position of the bitmap is represented by a byte, so, in total, a bitmap ocuppies 25 bytes. 
+  Each format is a mask of 25 bits, one per position of the bitmap.
   
   The x-axis go down and the y-axis go right.
   The top-left corner is considered the position (0,0) and the lower-right corner the position (4,4).
@@ -11,33 +11,12 @@
 #ifndef BITMAP_H
 #define BITMAP_H
 
-#include "utils.h"
-
-// Definition of the bitmap.
-typedef struct BitMap 
-{
-  // Internally, the bitmap is represented by an array of length 25.
-  byte field[25];
-} BitMap;
-
-// Allocs, dynamically, a new bitmap
-BitMap* new_BitMap();
+#include <stdint.h>
 
 /*
-  Update the contents of the bitmap to an format given by the type,
-  rotated by 'n' degrees, clockwise, with 'n' being 0, 90, 180 or 270.
-
-  Types available: 'I', 'P', 'T', 'X' and 'Z'.
+  Returns the format given by the type, rotated by 'n' degrees, clockwise, with 'n' being 0, 90, 180 or 270, as a 25-bit mask:
+  the bit x * 5 + y of the mask is set if the position (x,y) of the bitmap is part of the format.
 */
-void update_BitMap(BitMap* bitmap, char type, int n);
-
-// Set the (x,y) position of the bitmap to b
-void setValue_BitMap(BitMap* bitmap, int x, int y, byte b);
-
-// Returns the value in the position (x,y) of the bitmap
-byte getValue_BitMap(BitMap* bitmap, int x, int y);
-
-// Deallocs the bitmap
-void free_BitMap(BitMap*);
+uint32_t getMask_BitMap(char type, int n);
 
 #endif
@@ -0,0 +1,49 @@
+#include "bot.h"
+
+#include "io.h"
+#include <stdlib.h>
+
+Bot* new_Bot(int size, Random* random)
+{
+    Bot* bot = (Bot*) malloc(sizeof(Bot));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(bot == NULL)
+        prompt_IO(ERROR_IO, "bot.c, new_Bot(): first malloc failed");
+
+    bot->cells = (int*) malloc(size * size * sizeof(int));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(bot->cells == NULL)
+        prompt_IO(ERROR_IO, "bot.c, new_Bot(): second malloc failed");
+
+    split_Random(random, &bot->random);
+    bot->size = size;
+    bot->nr_left = size * size;
+    for(int i = 0; i < size * size; i++)
+        bot->cells[i] = i;
+
+    return bot;
+}
+
+void attack_Bot(Game* game, int id_player, int* p_x, int* p_y, void* context)
+{
+    Bot* bot = (Bot*) context;
+
+    // Case all cells were already attacked (the game would be over), notify and abort execution
+    if(bot->nr_left == 0)
+        prompt_IO(ERROR_IO, "bot.c, attack_Bot(): no cells left to attack");
+
+    // The cell chosen goes to the end of the cells left, so it's never chosen again
+    int i = range_Random(&bot->random, bot->nr_left);
+    int cell = bot->cells[i];
+    bot->cells[i] = bot->cells[--bot->nr_left];
+    bot->cells[bot->nr_left] = cell;
+
+    *p_x = cell / bot->size;
+    *p_y = cell % bot->size;
+}
+
+void free_Bot(Bot* bot)
+{
+    free(bot->cells);
+    free(bot);
+}
@@ -0,0 +1,37 @@
+/*
+  bot.h
+  Players controlled by the program.
+
+  A bot plays for one player of one game: it's given to the game with setAttacker_Game, with attack_Bot as the attacker.
+  Each bot has its own generator, split from another one, so games with bots are the same for the same seed, even when played in parallel.
+*/
+
+#ifndef BOT_H
+#define BOT_H
+
+#include "game.h"
+
+// Definition of the bot
+typedef struct Bot
+{
+    // Generator of the bot
+    Random random;
+
+    // Size of the map attacked
+    int size;
+
+    // Cells (x * size + y) not attacked yet, in the first 'nr_left' positions
+    int* cells;
+    int nr_left;
+} Bot;
+
+// Allocs a new bot, to attack a map of size * size, with a generator split from 'random'
+Bot* new_Bot(int size, Random* random);
+
+// Attacker (see game.h) where the bot, given as context, attacks a random cell not attacked before
+void attack_Bot(Game* game, int id_player, int* p_x, int* p_y, void* context);
+
+// Frees the bot
+void free_Bot(Bot* bot);
+
+#endif
@@ -1,25 +1,42 @@
 #include "cell.h"
 
-#include <stdlib.h>
 #include "io.h"
 
-Cell* new_Cell()
+void init_Cell(Cell* cell)
 {
-    Cell* cell = (Cell*) malloc(sizeof(Cell));
-    
-    // Case malloc failed, print that malloc failed and abort execution    
-    if(cell == NULL)
-        prompt_IO(ERROR_IO, "cell.c, new_Cell(): malloc failed");
+    // No piece (number 0) and the field shot to 0
+    cell->bits = 0;
+}
 
-    // Set field piece to NULL and the field shot to 0
-    cell->piece = NULL;
-    cell->shot = 0;
+bool hasPiece_Cell(Cell* cell)
+{
+    return (cell->bits >> 3) != 0;
+}
 
-    return cell;
+Piece* getPiece_Cell(Cell* cell, Piece* pieces)
+{
+    int number = cell->bits >> 3;
+    // The number of the piece is its position on the array plus one
+    return number == 0 ? NULL : &pieces[number - 1];
 }
 
-void free_Cell(Cell* cell)
+void setPiece_Cell(Cell* cell, Piece* pieces, Piece* piece)
 {
-    free(cell);
+    int number = piece == NULL ? 0 : (int) (piece - pieces) + 1;
+
+    // Case the piece doesn't fit in the 13 bits of the cell: notify and abort execution
+    if(number < 0 || number > MAX_PIECES_CELL)
+        prompt_IO(ERROR_IO, "cell.c, setPiece_Cell(): invalid piece");
+
+    cell->bits = (uint16_t) (number << 3 | (cell->bits & 7));
 }
 
+byte getShot_Cell(Cell* cell)
+{
+    return cell->bits & 7;
+}
+
+void setShot_Cell(Cell* cell, byte b)
+{
+    cell->bits = (uint16_t) ((cell->bits & ~7) | (b & 7));
+}
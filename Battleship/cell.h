@@ -2,7 +2,7 @@
   cell.h
   Representation of a cell.
 
-  Each cell has a pointer to a piece (if equals to NULL then the cell hasn't a piece), and field 'shot' meaning:
+  Each cell has the number of a piece (the position of the piece in the array of pieces of the map, see map.h) and a field 'shot' meaning:
     0 -> No shot;
     1 -> Missed shot;
     2 -> Shot that hit a piece I;
@@ -10,27 +10,49 @@
     4 -> Shot that hit a piece T;
     5 -> Shot that hit a piece X; 
     6 -> Shot that hit a piece Z;
+
+  Both are packed in 16 bits: the 3 lower bits are the field 'shot' and the 13 upper bits are the number of the piece plus one
+  (so 0 means that the cell hasn't a piece). This way a cell has only 2 bytes, instead of the 16 bytes of a pointer and a byte (with padding).
 */
 
 #ifndef CELL_H
 #define CELL_H
 
 #include "piece.h"
+#include <stdint.h>
+
+// Max number of pieces that a cell can refer to (13 bits, minus the value 0 that means no piece)
+#define MAX_PIECES_CELL 8191
 
 // Definition of the cell
 typedef struct Cell 
 {
-    Piece* piece;
-    byte shot;
+    uint16_t bits;
 } Cell;
 
-// Alloc, dynamically, a new cell and sets the field piece to NULL and the field shot to 0
-Cell* new_Cell();
-
 /*
-  Frees the cell. 
-  NOTE: The piece isn't freed. 
+  Function called for each cell visited in a region of a map (by the range queries of the quadtrees), with (x,y) being the position of the cell,
+  and 'context' being whatever was given to the query.
+  If it returns false, the query stops, otherwise, it goes on to the next cell.
 */
-void free_Cell(Cell*);
+typedef bool (*CellVisitor)(Cell* cell, int x, int y, void* context);
+
+// Sets a cell (already allocated) to have no piece and the field shot to 0
+void init_Cell(Cell* cell);
+
+// Returns true if the cell has a piece, otherwise returns false
+bool hasPiece_Cell(Cell* cell);
+
+// Returns the piece of the cell, from the array 'pieces' where the piece is, or NULL if the cell hasn't a piece
+Piece* getPiece_Cell(Cell* cell, Piece* pieces);
+
+// Sets the piece of the cell to 'piece', which must be in the array 'pieces' (or NULL, to remove the piece of the cell)
+void setPiece_Cell(Cell* cell, Piece* pieces, Piece* piece);
+
+// Returns the field shot of the cell
+byte getShot_Cell(Cell* cell);
+
+// Sets the field shot of the cell to b
+void setShot_Cell(Cell* cell, byte b);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,317 @@
+#include "density.h"
+
+#include "utils.h"
+#include "io.h"
+#include <stdlib.h>
+
+// Weight of each hit of its own type that a placement goes through (a placement with k such hits counts 1 + HIT_WEIGHT_DENSITY * k times)
+#define HIT_WEIGHT_DENSITY 16
+
+/*
+    A group of 5 hits of a type, with its format, isn't taken as a piece sunk while a legal placement of the type covers this many of its hits, and other cells:
+    the hits could be the end of one piece and the start of another (as two pieces I in line). Fewer hits in common are taken as very unlikely.
+*/
+#define MIN_SPLIT_DENSITY 4
+
+Density* new_Density(Player* target, Random* random)
+{
+    Density* density = (Density*) malloc(sizeof(Density));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(density == NULL)
+        prompt_IO(ERROR_IO, "density.c, new_Density(): malloc failed");
+
+    split_Random(random, &density->random);
+    density->size = target->map->size;
+    density->placement = new_Placement(density->size);
+
+    // The number of pieces of each type is part of the setup, known by both players
+    for(int i = 0; i < 5; i++) {
+        density->nr_per_piece[i] = 0;
+        density->nr_hits[i] = 0;
+    }
+    for(int i = 0; i < target->nr_pieces; i++)
+        density->nr_per_piece[getTypeIndex_Utils(target->pieces[i].type)]++;
+
+    for(int i = 0; i < 5; i++)
+        density->nr_sunk[i] = 0;
+    for(int x = 0; x < MAX_SIZE_PLACEMENT; x++) {
+        density->attacked[x] = 0;
+        density->sunk[x] = 0;
+        for(int i = 0; i < 5; i++)
+            density->hits[i][x] = 0;
+    }
+    density->last_x = density->last_y = -1;
+
+    return density;
+}
+
+void update_Density(Density* density, int x, int y, int shot)
+{
+    uint64_t bit = (uint64_t) 1 << y;
+    density->attacked[x] |= bit;
+
+    // Hit on the type shot - 2
+    if(shot >= 2 && shot <= 6 && !(density->hits[shot - 2][x] & bit)) {
+        density->hits[shot - 2][x] |= bit;
+        density->nr_hits[shot - 2]++;
+    }
+}
+
+/*
+    Returns true if the cells of 'component' (5 hits of the type, connected) have the format of some orientation of the type.
+    The rows of the component start on the row x.
+*/
+static bool isPiece(Placement* placement, int type, uint64_t component[], int x)
+{
+    // Smallest rectangle around the component
+    int height = 0;
+    uint64_t columns = 0;
+    while(height < 5 && x + height < placement->size && component[x + height] != 0)
+        columns |= component[x + height++];
+    int first_column = __builtin_ctzll(columns);
+
+    for(int k = 0; k < placement->nr_orientations[type]; k++) {
+        Orientation* orientation = &placement->orientations[type][k];
+        bool same = orientation->height == height;
+        for(int i = 0; i < height && same; i++)
+            same = orientation->rows[i] == component[x + i] >> first_column;
+        if(same)
+            return true;
+    }
+    return false;
+}
+
+/*
+    Returns true if the hits of 'component' (5 hits of the type with its format, the rows starting on the row x) could be of two pieces:
+    if some legal placement of the type (not crossing cells attacked, except the hits of the type) covers MIN_SPLIT_DENSITY of its cells, or more, but not all.
+*/
+static bool canBeSplit(Density* density, int type, uint64_t component[], int x)
+{
+    Placement* placement = density->placement;
+    int size = density->size;
+
+    // Columns of the component
+    uint64_t columns = 0;
+    for(int row = x; row < x + 5 && row < size; row++)
+        columns |= component[row];
+    int first_column = __builtin_ctzll(columns), last_column = 63 - __builtin_clzll(columns);
+
+    // The placements with some cell on the rectangle around the component
+    for(int k = 0; k < placement->nr_orientations[type]; k++) {
+        Orientation* orientation = &placement->orientations[type][k];
+        for(int cx = x - orientation->height + 1; cx < x + 5; cx++) {
+            for(int cy = first_column - orientation->width + 1; cy <= last_column; cy++) {
+                if(cx < 0 || cy < 0 || cx + orientation->height > size || cy + orientation->width > size)
+                    continue;
+
+                int covered = 0;
+                bool legal = true, outside = false;
+                for(int i = 0; i < orientation->height && legal; i++) {
+                    uint64_t cells = orientation->rows[i] << cy;
+                    legal = !(cells & density->attacked[cx + i] & ~density->hits[type][cx + i]);
+                    covered += __builtin_popcountll(cells & component[cx + i]);
+                    outside = outside || (cells & ~component[cx + i]);
+                }
+                if(legal && outside && covered >= MIN_SPLIT_DENSITY)
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+void findSunk_Density(Density* density)
+{
+    Placement* placement = density->placement;
+    int size = density->size;
+
+    for(int x = 0; x < size; x++)
+        density->sunk[x] = 0;
+
+    for(int type = 0; type < 5; type++) {
+        density->nr_sunk[type] = 0;
+
+        // Hits not on a group seen yet
+        uint64_t left[MAX_SIZE_PLACEMENT];
+        for(int x = 0; x < size; x++)
+            left[x] = density->hits[type][x];
+
+        for(int x = 0; x < size; x++) {
+            while(left[x] != 0) {
+                // The group of the first hit left, grown from it to the hits next to it (also on the diagonals, since the cells of the X only touch there),
+                // a row at a time, till it stops growing (the group starts on the row x, since the hits on the rows before were all on groups seen before)
+                uint64_t component[MAX_SIZE_PLACEMENT];
+                for(int row = 0; row < size; row++)
+                    component[row] = 0;
+                component[x] = left[x] & -left[x];
+
+                bool grown = true;
+                while(grown) {
+                    grown = false;
+                    for(int row = x; row < size; row++) {
+                        uint64_t around = component[row] | component[row - (row > 0)];
+                        if(row + 1 < size)
+                            around |= component[row + 1];
+                        uint64_t next = (around | (around << 1) | (around >> 1)) & density->hits[type][row];
+                        if(next != component[row]) {
+                            component[row] = next;
+                            grown = true;
+                        }
+                    }
+                }
+
+                int nr_cells = 0;
+                for(int row = x; row < size; row++) {
+                    nr_cells += __builtin_popcountll(component[row]);
+                    left[row] &= ~component[row];
+                }
+
+                if(nr_cells == 5 && isPiece(placement, type, component, x) && !canBeSplit(density, type, component, x)) {
+                    for(int row = x; row < x + 5 && row < size; row++)
+                        density->sunk[row] |= component[row];
+                    density->nr_sunk[type]++;
+                }
+            }
+        }
+    }
+}
+
+// Adds 'weight' to the counters of the cells of the row x with the bit set on 'mask'
+static void addRow(Density* density, int x, uint64_t mask, int weight)
+{
+    // Adding weight is adding 2^b for each bit b of weight, ie, adding the mask to the counters starting on the plane b
+    for(int b = 0; weight != 0 && mask != 0; b++, weight >>= 1) {
+        if(!(weight & 1))
+            continue;
+
+        uint64_t carry = mask;
+        for(int p = b; carry != 0 && p < PLANES_DENSITY; p++) {
+            uint64_t next = density->planes[p][x] & carry;
+            density->planes[p][x] ^= carry;
+            carry = next;
+        }
+    }
+}
+
+// Adds the placements of the orientation with the corner on the row x and the columns of 'anchors' to the cells they cover
+static void addPlacements(Density* density, Orientation* orientation, int x, uint64_t anchors, int weight)
+{
+    for(int i = 0; i < orientation->height; i++)
+        for(int j = 0; j < orientation->width; j++)
+            if((orientation->rows[i] >> j) & 1)
+                addRow(density, x + i, anchors << j, weight);
+}
+
+// Adds the legal placements of the type of piece to the counters, each weighted by the number of hits of the type, not on pieces sunk, it goes through
+static void addType(Density* density, int type, int weight)
+{
+    Placement* placement = density->placement;
+
+    // Legal placements don't cross any cell attacked, except the hits of the type, nor the pieces sunk (their cells are taken)
+    uint64_t hits[MAX_SIZE_PLACEMENT];
+    for(int x = 0; x < density->size; x++) {
+        hits[x] = density->hits[type][x] & ~density->sunk[x];
+        placement->taken[x] = (density->attacked[x] & ~density->hits[type][x]) | density->sunk[x];
+    }
+
+    for(int k = 0; k < placement->nr_orientations[type]; k++) {
+        Orientation* orientation = &placement->orientations[type][k];
+        for(int x = 0; x + orientation->height <= density->size; x++) {
+            uint64_t anchors = anchors_Placement(placement, orientation, x);
+            if(anchors == 0)
+                continue;
+
+            if(density->nr_hits[type] == 5 * density->nr_sunk[type]) {
+                addPlacements(density, orientation, x, anchors, weight);
+                continue;
+            }
+
+            // Number of hits under each placement of the row (0 to 5), bit-sliced on the bits 'ones', 'twos' and 'fours'
+            uint64_t ones = 0, twos = 0, fours = 0;
+            for(int i = 0; i < orientation->height; i++)
+                for(int j = 0; j < orientation->width; j++)
+                    if((orientation->rows[i] >> j) & 1) {
+                        uint64_t hit = hits[x + i] >> j;
+                        uint64_t carry = ones & hit;
+                        ones ^= hit;
+                        fours |= twos & carry;
+                        twos ^= carry;
+                    }
+
+            for(int nr = 0; nr <= 5; nr++) {
+                uint64_t with_nr = anchors & (nr & 1 ? ones : ~ones) & (nr & 2 ? twos : ~twos) & (nr & 4 ? fours : ~fours);
+                if(with_nr != 0)
+                    addPlacements(density, orientation, x, with_nr, weight * (1 + HIT_WEIGHT_DENSITY * nr));
+            }
+        }
+    }
+}
+
+void compute_Density(Density* density)
+{
+    for(int b = 0; b < PLANES_DENSITY; b++)
+        for(int x = 0; x < density->size; x++)
+            density->planes[b][x] = 0;
+
+    // Only the pieces still afloat are counted
+    findSunk_Density(density);
+    for(int type = 0; type < 5; type++) {
+        int afloat = density->nr_per_piece[type] - density->nr_sunk[type];
+        if(afloat > 0)
+            addType(density, type, afloat);
+    }
+}
+
+int get_Density(Density* density, int x, int y)
+{
+    int counter = 0;
+    for(int b = 0; b < PLANES_DENSITY; b++)
+        counter |= (int) ((density->planes[b][x] >> y) & 1) << b;
+    return counter;
+}
+
+void choose_Density(Density* density, int* p_x, int* p_y)
+{
+    int best = -1, nr_best = 0;
+    for(int x = 0; x < density->size; x++) {
+        for(int y = 0; y < density->size; y++) {
+            if((density->attacked[x] >> y) & 1)
+                continue;
+
+            // The ties are broken uniformly: the cell number n with the best counter replaces the chosen with probability 1/n
+            int counter = get_Density(density, x, y);
+            if(counter > best) {
+                best = counter;
+                nr_best = 0;
+            }
+            if(counter == best && range_Random(&density->random, ++nr_best) == 0) {
+                *p_x = x;
+                *p_y = y;
+            }
+        }
+    }
+
+    // Case all cells were already attacked (the game would be over), notify and abort execution
+    if(best < 0)
+        prompt_IO(ERROR_IO, "density.c, choose_Density(): no cells left to attack");
+}
+
+void attack_Density(Game* game, int id_player, int* p_x, int* p_y, void* context)
+{
+    Density* density = (Density*) context;
+
+    // The result of the last attack is on the shots map of the player
+    if(density->last_x >= 0)
+        update_Density(density, density->last_x, density->last_y, getShotStatus_Player(game->players[id_player], density->last_x, density->last_y));
+
+    compute_Density(density);
+    choose_Density(density, p_x, p_y);
+    density->last_x = *p_x;
+    density->last_y = *p_y;
+}
+
+void free_Density(Density* density)
+{
+    free_Placement(density->placement);
+    free(density);
+}
@@ -0,0 +1,80 @@
+/*
+  density.h
+  Computer player that attacks by probability density.
+
+  For each cell not attacked yet, it counts how many legal placements of the pieces still afloat cover the cell, and attacks the cell with most.
+  A placement of a type of piece is legal if it doesn't cross a miss, nor a hit of another type (the result of an attack tells the type hitted), nor a piece already sunk.
+  Placements through hits of their own type (not sunk) are weighted up, so after a hit the bot keeps attacking around it, till the piece is sunk.
+
+  The placements are counted with the engine of placement.h, a whole row of anchors at a time,
+  and added to the counters of the cells also a row at a time: the counters are bit-sliced, ie, the bit b of the counter of (x,y)
+  is the bit y of the word planes[b][x], so adding one row of placements to a row of counters is a ripple carry of words.
+*/
+
+#ifndef DENSITY_H
+#define DENSITY_H
+
+#include "game.h"
+#include "placement.h"
+
+// Number of bits of the counters of the cells
+#define PLANES_DENSITY 24
+
+// Definition of the bot
+typedef struct Density
+{
+    // Generator of the bot, to break ties between the cells
+    Random random;
+
+    // Size of the map attacked and number of pieces of each type on it (as in getType_Utils)
+    int size;
+    int nr_per_piece[5];
+
+    // Engine used to count the legal placements
+    Placement* placement;
+
+    // Cells already attacked, and the ones hitted, by type (bit y of the row x for the cell (x,y))
+    uint64_t attacked[MAX_SIZE_PLACEMENT];
+    uint64_t hits[5][MAX_SIZE_PLACEMENT];
+    int nr_hits[5];
+
+    // The pieces already sunk (groups of 5 hits of a type with its format), as cells, and how many of each type (see findSunk_Density)
+    uint64_t sunk[MAX_SIZE_PLACEMENT];
+    int nr_sunk[5];
+
+    // Last cell attacked (x is -1 before the first attack), whose result is read on the next attack
+    int last_x, last_y;
+
+    // Counters of the cells, bit-sliced
+    uint64_t planes[PLANES_DENSITY][MAX_SIZE_PLACEMENT];
+} Density;
+
+// Allocs a new bot, to attack the map of the player 'target' (only its size and the types of its pieces are seen), with a generator split from 'random'
+Density* new_Density(Player* target, Random* random);
+
+// Registers the result of an attack on (x,y), with the value of the shot (as in getShotStatus_Player: 1 for a miss, 2 to 6 for a hit on I, P, T, X or Z)
+void update_Density(Density* density, int x, int y, int shot);
+
+/*
+  Finds the pieces already sunk, with the attacks registered: the groups of 5 connected hits of a type with the format of that type,
+  marked on 'sunk' and counted on 'nr_sunk'. The hits of two pieces of the same type could look like that: a group is only taken while
+  no legal placement of the type shares most of its hits (see MIN_SPLIT_DENSITY), and other groups are taken as very unlikely.
+*/
+void findSunk_Density(Density* density);
+
+// Computes the counters of all the cells, with the attacks registered (and the pieces sunk found again)
+void compute_Density(Density* density);
+
+// Returns the counter of the cell (x,y), from the last compute_Density
+int get_Density(Density* density, int x, int y);
+
+// Writes on (*p_x, *p_y) the cell not attacked with the highest counter (ties are broken at random)
+void choose_Density(Density* density, int* p_x, int* p_y);
+
+// Attacker (see game.h) where the bot, given as context, registers the result of its last attack and attacks the best cell
+void attack_Density(Game* game, int id_player, int* p_x, int* p_y, void* context);
+
+// Frees the bot
+void free_Density(Density* density);
+
+#endif
@@ -2,40 +2,27 @@
 
 #include "io.h"
 #include "utils.h"
-#include <time.h>
+#include "placement.h"
+#include "packing.h"
+#include "record.h"
 #include <stdlib.h>
 
-// Function to generate a random degree to the rotation
-static int randomDegree()
-{
-    int aux = rand() % 4;
-    switch(aux) {
-        case 0: return 0;
-        case 1: return 90;
-        case 2: return 180;
-        case 3: return 270;
-    }
-
-    // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
-    return 0;
-}
-
 // Function used to generate the map size, number of pieces per type and the first player attacking
-static void generateSetup(int* p_map_size, int nr_per_piece[5], int* p_player_attacking)
+static void generateSetup(Random* random, int* p_map_size, int nr_per_piece[5], int* p_player_attacking)
 {
     // Generate map size
-    *p_map_size = ((rand() % 20) + 1) + 20;
+    *p_map_size = (range_Random(random, 20) + 1) + 20;
 
     // Generate number of piece per type
     int nrBarcosLeft = (*p_map_size * *p_map_size) / 25; 
     for(int i = 4; i >= 0; i--) {
         // Make sure every type has, at least, one piece
-        nr_per_piece[i] = (rand() % (nrBarcosLeft - i)) + 1; 
+        nr_per_piece[i] = range_Random(random, nrBarcosLeft - i) + 1; 
         nrBarcosLeft -= nr_per_piece[i];
     }
 
     // Generate the first player attacking
-    *p_player_attacking = (rand() % 2 == 0) ? 0 : 1;
+    *p_player_attacking = range_Random(random, 2);
 }
 
 
@@ -46,8 +33,15 @@ static void chooseGame(Game* game)
     int map_size;
     int nr_per_piece[5];
     do {
-        prompt_IO(READ_SETUP_IO, &map_size, nr_per_piece, &game->player_attacking);
-        prompt_IO(CONFIRM_SETUP_IO, map_size, nr_per_piece, game->player_attacking, &confirmed, 0);
+        read_IO(game->source, READ_SETUP_IO, &map_size, nr_per_piece, &game->player_attacking);
+
+        // Case the pieces can't all fit in the map, notify and read another setup.
+        // If the solver couldn't decide, the setup is taken, and the placement of the pieces tells if some doesn't fit.
+        if(solve_Packing(map_size, nr_per_piece, NULL) == DOESNT_FIT_PACKING) {
+            event_IO(game->sink, SETUP_INFEASIBLE_IO, 0);
+            continue;
+        }
+        read_IO(game->source, CONFIRM_SETUP_IO, map_size, nr_per_piece, game->player_attacking, &confirmed, 0);
     } while(!confirmed);
 
     // Alloc and read the map of the players
@@ -60,63 +54,98 @@ static void chooseGame(Game* game)
             
             for(int piece_number = 1; piece_number <= nr_per_piece[piece_type]; piece_number++) {
 
-                Piece* piece = new_Piece();
+                Piece* piece = nextPiece_Player(game->players[id_player]);
                 int px, py, degree_of_rotation;
 
                 int resultAddingPiece;
                 do {
-                    prompt_IO(READ_PIECE_IO, id_player, piece_number, type, &px, &py, &degree_of_rotation);
+                    read_IO(game->source, READ_PIECE_IO, id_player, piece_number, type, &px, &py, &degree_of_rotation);
                     update_Piece(piece, type, px, py, degree_of_rotation);
                     resultAddingPiece = addPiece_Player(game->players[id_player], piece);
-                    prompt_IO(RESULT_ADDING_PIECE_IO, resultAddingPiece);
+                    event_IO(game->sink, RESULT_ADDING_PIECE_IO, resultAddingPiece);
                 } while(resultAddingPiece != 0);
             }
         }
-        prompt_IO(PIECES_MAP_IO, game->players[id_player], id_player);
+        event_IO(game->sink, PIECES_MAP_IO, game->players[id_player], id_player);
+        read_IO(game->source, CONTINUE_IO, id_player);
     }
 }
 
-static void randomGame(Game* game)
+/*
+    Places the pieces of a player, at random, with the engine of legal placements (each piece is placed uniformly among the placements left).
+    Returns false if some piece had no legal placement left, otherwise returns true.
+*/
+static bool randomPieces(Random* random, Player* player, int map_size, int nr_per_piece[5])
 {
-    // Get a new seed, based on current time of the system
-    srand(time(NULL));
+    Placement* placement = new_Placement(map_size);
 
-    bool confirmed = false;
-    int map_size;
-    int nr_per_piece[5];
+    bool placed = true;
+    for(int i = 0; i < 5 && placed; i++) {
+        for(int j = 0; j < nr_per_piece[i] && placed; j++) {
+            Piece* piece = nextPiece_Player(player);
+            placed = random_Placement(placement, i, piece, random);
+
+            // The engine only gives legal placements, so the map must accept the piece
+            if(placed && addPiece_Player(player, piece) != 0)
+                prompt_IO(ERROR_IO, "game.c, randomPieces(): legal placement not accepted by the map");
+        }
+    }
+
+    free_Placement(placement);
+    return placed;
+}
+
+// Generates a random setup (as generateSetup), where the pieces can all fit in the map (a packing was found, not only not ruled out)
+static void randomSetup(Game* game, int* p_map_size, int nr_per_piece[5])
+{
+    do
+        generateSetup(&game->random, p_map_size, nr_per_piece, &game->player_attacking);
+    while(solve_Packing(*p_map_size, nr_per_piece, NULL) != FITS_PACKING);
+}
+
+/*
+    Allocs both players and places their pieces at random.
+    Returns false (and nothing stays allocated) if some piece couldn't be placed, otherwise returns true.
+*/
+static bool randomPlayers(Game* game, int map_size, int nr_per_piece[5])
+{
+    // Place the pieces of both players, stopping as soon as some piece can't be placed
+    int nr_players = 0;
+    bool placed = true;
+    while(nr_players < 2 && placed) {
+        game->players[nr_players] = new_Player(map_size);
+        placed = randomPieces(&game->random, game->players[nr_players], map_size, nr_per_piece);
+        nr_players++;
+    }
+
+    if(!placed)
+        for(int p = 0; p < nr_players; p++)
+            free_Player(game->players[p]);
+    return placed;
+}
+
+static void randomGame(Game* game)
+{
+    bool placed;
     do {
-        generateSetup(&map_size, nr_per_piece, &game->player_attacking);
-        prompt_IO(CONFIRM_SETUP_IO, map_size, nr_per_piece, game->player_attacking, &confirmed, 1);
-    } while(!confirmed);
-        
-    for(int p = 0; p < 2; p++) {
-        game->players[p] = new_Player(map_size);
+        bool confirmed = false;
+        int map_size;
+        int nr_per_piece[5];
+        do {
+            randomSetup(game, &map_size, nr_per_piece);
+            read_IO(game->source, CONFIRM_SETUP_IO, map_size, nr_per_piece, game->player_attacking, &confirmed, 1);
+        } while(!confirmed);
 
-        for(int i = 0; i < 5; i++) {
-            char type = getType_Utils(i);
+        // Case the pieces didn't fit, notify and go back to generate another setup
+        placed = randomPlayers(game, map_size, nr_per_piece);
+        if(!placed)
+            event_IO(game->sink, SETUP_INFEASIBLE_IO, 1);
+    } while(!placed);
 
-            for(int j = 0; j < nr_per_piece[i]; j++) {
-                
-                Piece* piece = new_Piece();
-                int px, py, degree_of_rotation;
-                
-                do {
-                    // This variables px and py correspond to the center of the piece, so a valid piece, must have this values, inside the map.
-                    px = rand() % map_size;
-                    py = rand() % map_size;
-                    
-                    // Random degree of rotation
-                    degree_of_rotation = randomDegree();
-                    
-                    // Update the piece
-                    update_Piece(piece, type, px, py, degree_of_rotation);
-                
-                    // Tries to add the piece to the map till the piece can be (when the return is 0 that means that the piece could and was attactched to the map, so we break the loop)
-                } while(addPiece_Player(game->players[p], piece) != 0); 
-            }
-        }
-        // Print the map of pieces
-        prompt_IO(PIECES_MAP_IO, game->players[p], p);
+    // Print the maps of pieces
+    for(int p = 0; p < 2; p++) {
+        event_IO(game->sink, PIECES_MAP_IO, game->players[p], p);
+        read_IO(game->source, CONTINUE_IO, p);
     }
 }
 
@@ -126,8 +155,7 @@ static void changeTurn(Game* game)
     game->player_attacking = (game->player_attacking + 1) % 2;
 }
 
-// Deallocs the game and all the resources needed
-static void free_Game(Game* game)
+void free_Game(Game* game)
 {
     free_Player(game->players[0]);
     free_Player(game->players[1]);
@@ -135,16 +163,35 @@ static void free_Game(Game* game)
 }
 
 
-Game* init_Game()
+// Allocs the game, with the generator seeded with 'seed', the IO on 'sink' and 'source', no players yet and no attackers
+static Game* new_Game(uint64_t seed, Sink* sink, Source* source)
 {
     // Alloc, dynamically, the game
     Game* game = (Game*) malloc(sizeof(Game));
     if(game == NULL)
         prompt_IO(ERROR_IO, "game.c, new_Game(): malloc failed");   
 
+    seed_Random(&game->random, seed);
+    for(int p = 0; p < 2; p++) {
+        game->attackers[p] = NULL;
+        game->contexts[p] = NULL;
+    }
+    game->turns = 0;
+    game->sink = sink;
+    game->source = source;
+    game->seed = seed;
+    game->record = NULL;
+
+    return game;
+}
+
+Game* init_Game(uint64_t seed, Sink* sink, Source* source)
+{
+    Game* game = new_Game(seed, sink, source);
+
     // Prompt to ask if the game will be random generated or choosen manual
     bool randomize;
-    prompt_IO(READ_RANDOMIZE_IO, &randomize);
+    read_IO(game->source, READ_RANDOMIZE_IO, &randomize);
 
     switch(randomize) {
         // Manual choose
@@ -156,25 +203,90 @@ Game* init_Game()
     return game;
 }
 
+Game* newHeadless_Game(uint64_t seed)
+{
+    // No events are reported, and there are no reads while both players have attackers (a read aborts execution)
+    Game* game = new_Game(seed, null_Sink(), null_Source());
+
+    // Random setup, already confirmed, generated again till the pieces are placed
+    int map_size;
+    int nr_per_piece[5];
+    do
+        randomSetup(game, &map_size, nr_per_piece);
+    while(!randomPlayers(game, map_size, nr_per_piece));
+
+    return game;
+}
+
+Game* newSetup_Game(uint64_t seed, int map_size, int player_attacking, Piece* pieces[2], int nr_pieces)
+{
+    Game* game = new_Game(seed, null_Sink(), null_Source());
+    game->player_attacking = player_attacking;
+
+    for(int p = 0; p < 2; p++) {
+        game->players[p] = new_Player(map_size);
+        for(int i = 0; i < nr_pieces; i++) {
+            // The piece is copied to the array of the player, where the map refers to it
+            Piece* piece = nextPiece_Player(game->players[p]);
+            *piece = pieces[p][i];
+            if(addPiece_Player(game->players[p], piece) != 0) {
+                for(int q = 0; q <= p; q++)
+                    free_Player(game->players[q]);
+                free(game);
+                return NULL;
+            }
+        }
+    }
+
+    return game;
+}
+
+void setAttacker_Game(Game* game, int id_player, Attacker attacker, void* context)
+{
+    game->attackers[id_player] = attacker;
+    game->contexts[id_player] = context;
+}
+
 void playTurn_Game(Game* game) 
 {   
+    // The attacks come from the source if the player has no attacker
+    Attacker attacker = game->attackers[PLAYER_ATTACKING];
+
     // Get the (x,y) coordinates of the attack
     int x, y;
-    prompt_IO(ATTACK_COORDINATES_IO, PLAYER_ATTACKING, &x, &y);
-    
+    if(attacker != NULL)
+        attacker(game, PLAYER_ATTACKING, &x, &y, game->contexts[PLAYER_ATTACKING]);
+    else
+        read_IO(game->source, ATTACK_COORDINATES_IO, PLAYER_ATTACKING, &x, &y);
+
+    attack_Game(game, x, y);
+}
+
+int attack_Game(Game* game, int x, int y)
+{
     // Attack the player and get the result of the attack
     int attack_result = registerAttack_Player(game->players[PLAYER_UNDER_ATTACK], x, y);
 
     // Register the attack on the player attacking
     registerShot_Player(game->players[PLAYER_ATTACKING], x, y, attack_result);
+    if(game->record != NULL)
+        attack_Record(game->record, PLAYER_ATTACKING, x, y, attack_result);
     
-    // Print the result of the attack
-    prompt_IO(ATTACK_RESULT_IO, attack_result);
-    // Print the shots map of the player attacking
-    prompt_IO(SHOTS_MAP_IO, game->players[PLAYER_ATTACKING]);
+    // Report the result of the attack
+    event_IO(game->sink, ATTACK_RESULT_IO, attack_result);
+    // Report the shots map of the player attacking
+    event_IO(game->sink, SHOTS_MAP_IO, game->players[PLAYER_ATTACKING], PLAYER_ATTACKING);
     
     // Change turns
+    game->turns++;
     changeTurn(game);
+    return attack_result;
+}
+
+void setRecord_Game(Game* game, struct Record* record)
+{
+    game->record = record;
+    start_Record(record, game);
 }
 
 bool over_Game(Game* game)
@@ -185,7 +297,7 @@ bool over_Game(Game* game)
         and if he lost, the player that won is now the player under the attack
     */
     if(game->players[PLAYER_ATTACKING]->hp == 0) {
-        prompt_IO(GAME_OVER_IO, PLAYER_UNDER_ATTACK);
+        event_IO(game->sink, GAME_OVER_IO, PLAYER_UNDER_ATTACK);
         return true;
     }
     return false;
@@ -193,11 +305,11 @@ bool over_Game(Game* game)
 
 bool exit_Game(Game* game)
 {
-    // At this point, the game is finished, so we can free the game and all resources needed
-    free_Game(game);
-
     // Prompt to play again. The variable play_again if is setted to true, then is to play again, if is setted to false, then isn't to play again.
     bool play_again;
-    prompt_IO(PLAY_AGAIN_IO, &play_again);
+    read_IO(game->source, PLAY_AGAIN_IO, &play_again);
+
+    // At this point, the game is finished, so we can free the game and all resources needed
+    free_Game(game);
     return !play_again;
 }
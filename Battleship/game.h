@@ -7,6 +7,17 @@
 #define GAME_H
 
 #include "player.h"
+#include "random.h"
+#include "io.h"
+
+struct Game;
+struct Record;
+
+/*
+    Function that chooses, for the player 'id_player', the (x,y) coordinates of his next attack, 
+    for the players controlled by the program (instead of the terminal). 'context' is whatever was given with the function.
+*/
+typedef void (*Attacker)(struct Game* game, int id_player, int* p_x, int* p_y, void* context);
 
 // Definition of the game
 typedef struct Game
@@ -15,18 +26,64 @@ typedef struct Game
     int player_attacking;
     // The two players
     Player* players[2];
+    // Generator of the random setups, owned by the game
+    Random random;
+    // Function that chooses the attacks of each player (NULL for the players on the terminal), and its context
+    Attacker attackers[2];
+    void* contexts[2];
+    // Number of turns played
+    int turns;
+    // Where the events of the game go and where its reads come from (not owned by the game)
+    Sink* sink;
+    Source* source;
+    // Seed of the generator of the game
+    uint64_t seed;
+    // Record where the attacks are written (see record.h), or NULL (not owned by the game)
+    struct Record* record;
 } Game;
 
-//  Build the game: prompting the configurations and allocating all resources needed
-Game* init_Game();
+/*
+    Build the game: prompting the configurations and allocating all resources needed.
+    The random setups come from the generator of the game, seeded with 'seed', so the same seed gives the same game.
+    All the events of the game go to 'sink' and all its reads come from 'source' (see io.h), which must live longer than the game.
+*/
+Game* init_Game(uint64_t seed, Sink* sink, Source* source);
+
+/*
+    Build a game with a random setup, without any IO (the setup is taken as confirmed, the events go to the null sink and the reads to the null source).
+    Before playing, the attackers of both players must be set, with setAttacker_Game (a read of the game aborts execution).
+    When the game is over, it's freed with free_Game.
+*/
+Game* newHeadless_Game(uint64_t seed);
+
+/*
+    Build a game with the setup given, without any IO (as newHeadless_Game): the map size, the first player attacking and the pieces of each player,
+    'nr_pieces' each, added in order. Returns NULL (and nothing stays allocated) if some piece can't be added.
+*/
+Game* newSetup_Game(uint64_t seed, int map_size, int player_attacking, Piece* pieces[2], int nr_pieces);
+
+// Sets the function that chooses the attacks of the player 'id_player' (NULL to read them from the source of the game)
+void setAttacker_Game(Game* game, int id_player, Attacker attacker, void* context);
 
 /*
-    The player attacking chooses an (x,y) to attack the other player. 
+    The player attacking chooses an (x,y) to attack the other player (from the source of the game, or with his attacker). 
     In the end, they switch, so the player that suffer the attack is now the next player attacking
     and the player attacking is now the next player suffering the next attack.
 */
 void playTurn_Game(Game*);
 
+/*
+    The player attacking attacks (x,y), as on playTurn_Game, but with the coordinates given.
+    Returns the result of the attack (as registerAttack_Player).
+*/
+int attack_Game(Game* game, int x, int y);
+
+/*
+    Starts recording the game on 'record' (see record.h), with its setup: the attacks from now on are added to the record.
+    Must be called before the first turn.
+*/
+void setRecord_Game(Game* game, struct Record* record);
+
 //   Returns true if the game ended, ie, one of the players has all pieces destroyed, false otherwise.
 bool over_Game(Game*);
 
@@ -36,4 +93,7 @@ bool over_Game(Game*);
 */
 bool exit_Game(Game*);
 
+// Deallocs the game and all the resources allocated by the game, without any IO
+void free_Game(Game*);
+
 #endif
\ No newline at end of file
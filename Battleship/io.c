@@ -1,6 +1,7 @@
 #include "io.h"
 
 #include <stdio.h>
+#include <sys/ioctl.h>
 #include <ctype.h>
 #include <unistd.h>
 #include <stdarg.h>
@@ -62,24 +63,56 @@ static bool canConvertStringToInt(char* str)
     else
         return false;
 }
+/*
+    What the terminal sink has drawn on the screen, so the shots maps are redrawn only on the cells that changed (see printShots).
+    When stdout is a terminal with room for the maps, they're drawn on the top of the cleared screen, side by side (one region per player) if there's room for both,
+    and the lines below them become the scrolling region, where all the other text goes (prompts, results), so the maps stay in place.
+    The next shots maps only move the cursor to the cells that changed since the map on their region, and write them.
+*/
+typedef struct Screen
+{
+    // True if the maps are on the top of the screen, with the scrolling region below them
+    bool drawn;
 
-void prompt_IO(int identifier, ...)
+    // Size of the maps, number of regions (1, or 2 if the maps of both players fit side by side) and width of each region
+    int size, nr_regions, width;
+
+    // Player whose map is on each region (0 if none yet) and its cells (as in exportRows_Map)
+    int id_players[2];
+    byte* frames[2];
+} Screen;
+
+static Screen screen = { false, 0, 0, 0, { 0, 0 }, { NULL, NULL } };
+
+// Gives back the whole screen as the scrolling region, keeping the cursor where it is (called at exit, if a map was drawn)
+static void releaseScreen()
 {
-    va_list args;
-    va_start(args, identifier);
+    if(screen.drawn) {
+        fputs("\x1b" "7" "\x1b[r" "\x1b" "8", stdout);
+        fflush(stdout);
+        screen.drawn = false;
+    }
+}
+
+// Clears the screen and moves the cursor to its top, with escape sequences (the same ones written by the command clear)
+static void clearScreen()
+{
+    if(screen.drawn) {
+        fputs("\x1b[r", stdout);
+        screen.drawn = false;
+    }
+    fputs("\x1b[H\x1b[2J\x1b[3J", stdout);
+}
 
+// Source of the terminal: reads from stdin, printing what the player needs to know to answer
+static void terminalRead(Source* source, int identifier, va_list args)
+{
     switch (identifier)
     {
-        case ERROR_IO: {
-            char* error_message = va_arg(args, char*);
-            puts(error_message);
-            exit(EXIT_FAILURE);
-        }
-
         case READ_RANDOMIZE_IO:
         {
 
-	    system("clear");
+            clearScreen();
             char buffer[BUFFERSIZE];
 
             bool *p_randomize = va_arg(args, bool*);
@@ -252,7 +285,7 @@ void prompt_IO(int identifier, ...)
             bool* p_confirmed = va_arg(args, bool*);
             int text_option = va_arg(args, int);
 
-            system("clear");
+            clearScreen();
             printf("[System] The size of the maps will be equal to %d.\n", map_size);
             printf("[System] Both players will have %d pieces of type I, %d of type P, %d of type T, %d of type X and %d of type Z.\n", p_nr_per_piece[0], p_nr_per_piece[1], p_nr_per_piece[2], p_nr_per_piece[3], p_nr_per_piece[4]);
             printf("[System] The first player attacking is the player %d.\n", first_player_attacking + 1);
@@ -281,7 +314,7 @@ void prompt_IO(int identifier, ...)
                 else
                     printf("[System] Invalid option! Try again.\n\n");
             } while(!valid);
-            system("clear");
+            clearScreen();
             break;
         }
 
@@ -334,23 +367,6 @@ void prompt_IO(int identifier, ...)
             break;
         }
 
-        case ATTACK_RESULT_IO:
-        {
-            int attack_result = va_arg(args, int);
-
-            switch(attack_result) {
-                case -1: puts("[System] Attacked outside the map!"); break;
-                case  0: puts("[System] MISS!!!"); break;
-                case  1: puts("[System] HITTED A PIECE OF TYPE I!!!"); break;
-                case  2: puts("[System] HITTED A PIECE OF TYPE P!!!"); break;
-                case  3: puts("[System] HITTED A PIECE OF TYPE T!!!"); break;
-                case  4: puts("[System] HITTED A PIECE OF TYPE X!!!"); break;
-                case  5: puts("[System] HITTED A PIECE OF TYPE Z!!!"); break;
-                case  6: puts("[System] Attacked an piece already hitted!!!"); break;
-            }
-            break;
-        }
-
         case READ_PIECE_IO:
         {
             char buffer[BUFFERSIZE];
@@ -437,6 +453,226 @@ void prompt_IO(int identifier, ...)
             break;
         }
 
+        case PLAY_AGAIN_IO:
+        {
+            char buffer[BUFFERSIZE];
+
+            // Pointer to the address where it's gonna be written the result of playing again.
+            bool* play_again = va_arg(args, bool*);
+
+            puts("[System] Thank you for playing!");
+
+            bool valid = false;
+            do {
+                // Could read the input, properly
+                do
+                    printf("[System] Wanna play again? Write 'again' for playing again, or 'quit' to leave.\n[Player] ");
+                while(!readInput(buffer));
+
+                // Input verify the restriction
+                if(strcmp(buffer, "again") == 0 || strcmp(buffer, "a") == 0) {
+                    valid = true;
+                    *play_again = true;
+                    clearScreen();
+                }
+                else if(strcmp(buffer, "quit") == 0 || strcmp(buffer, "q") == 0) {
+                    valid = true;
+                    *play_again = false;
+                    puts("[System] Hope you had fun!");
+                }
+                else
+                    puts("[System] Unknown command. Try again!\n");
+            } while(!valid);
+
+            break;
+        }
+
+        // Waits for enter, so the player sees his map of pieces, and then clears it.
+        case CONTINUE_IO:
+        {
+            char buffer[BUFFERSIZE];
+
+            int id_player = va_arg(args, int);
+            // Normalize the id.
+            id_player++;
+
+            printf("[System] Press enter...\n[Player%d] ", id_player);
+            while(!readInput(buffer));
+            clearScreen();
+            break;
+        }
+
+        // Invalid identifier
+        default:
+        {
+            prompt_IO(ERROR_IO, "io.c, terminalRead(): invalid identifier");
+            break;
+        }
+    }
+}
+
+// Characters of the cells of the maps printed, by the values of exportRows_Map (see map.h)
+static const char pieceChars[] = ".IPTXZX";
+static const char shotChars[] = ".MIPTXZ";
+
+/*
+    Prints the map of pieces, or of shots, of the player, between the lines 'header' and 'footer', with one write.
+    The whole map is exported at once (see exportRows_Map) and formatted on one buffer, with the cells of a row separated by spaces.
+*/
+static void printMap(Player* player, bool pieces, const char* header, const char* footer)
+{
+    int size = player->map->size;
+    size_t header_length = strlen(header), footer_length = strlen(footer);
+    byte* rows = (byte*) malloc((size_t) size * size);
+    char* text = (char*) malloc(header_length + (size_t) 2 * size * size + footer_length);
+    // Case malloc failed, print that malloc failed and abort execution
+    if(rows == NULL || text == NULL)
+        prompt_IO(ERROR_IO, "io.c, printMap(): malloc failed");
+
+    exportRows_Map(player->map, rows, pieces);
+    const char* chars = pieces ? pieceChars : shotChars;
+
+    char* p = text;
+    memcpy(p, header, header_length);
+    p += header_length;
+    for(byte* row = rows; row < rows + size * size; row += size) {
+        for(int y = 0; y < size; y++) {
+            *p++ = chars[row[y]];
+            *p++ = ' ';
+        }
+        p[-1] = '\n';
+    }
+    memcpy(p, footer, footer_length);
+    p += footer_length;
+
+    fwrite(text, 1, p - text, stdout);
+    free(rows);
+    free(text);
+}
+
+// Returns the number of columns of stdout, if it's a terminal with room for a map of 'size' and a scrolling region of some lines below it, otherwise returns 0
+static int columnsForMap(int size)
+{
+    struct winsize window;
+    if(!isatty(STDOUT_FILENO) || ioctl(STDOUT_FILENO, TIOCGWINSZ, &window) != 0)
+        return 0;
+    return window.ws_row >= size + 8 && window.ws_col >= 2 * size ? window.ws_col : 0;
+}
+
+// Sets the screen up for maps of 'size', on the terminal with 'columns' columns: clears it and leaves the lines below the maps as the scrolling region
+static void setupScreen(int size, int columns)
+{
+    // Each region has the map (2 * size - 1 columns) and the header, with some space till the next one
+    screen.size = size;
+    screen.width = 2 * size + 4 > 40 ? 2 * size + 4 : 40;
+    screen.nr_regions = columns >= 2 * screen.width ? 2 : 1;
+    for(int r = 0; r < 2; r++) {
+        byte* frame = (byte*) realloc(screen.frames[r], (size_t) size * size);
+        // Case realloc failed, print that realloc failed and abort execution
+        if(frame == NULL)
+            prompt_IO(ERROR_IO, "io.c, setupScreen(): realloc failed");
+        screen.frames[r] = frame;
+        screen.id_players[r] = 0;
+    }
+
+    static bool released_at_exit = false;
+    if(!released_at_exit)
+        released_at_exit = atexit(releaseScreen) == 0;
+
+    // Headers on the line 1, the rows on the lines 2 to size + 1, and the scrolling region from the line size + 3
+    clearScreen();
+    printf("\x1b[%d;r\x1b[%d;1H", size + 3, size + 3);
+    screen.drawn = true;
+}
+
+// Prints the map of shots of the player, redrawing only the cells that changed, if the map is already on the screen (see Screen)
+static void printShots(Player* player, int id_player)
+{
+    int size = player->map->size;
+    char header[BUFFERSIZE];
+    snprintf(header, sizeof(header), "[System] Attack map of the player %d.", id_player);
+
+    // Case there's no room for the maps on the screen, they're printed in full, with the other text
+    if(!screen.drawn || screen.size != size) {
+        int columns = columnsForMap(size);
+        if(columns == 0) {
+            strcat(header, "\n");
+            printMap(player, false, header, "\n");
+            return;
+        }
+        setupScreen(size, columns);
+    }
+
+    int r = screen.nr_regions == 2 ? id_player - 1 : 0;
+    int column = 1 + r * screen.width;
+    byte* frame = screen.frames[r];
+    byte* rows = (byte*) malloc((size_t) size * size);
+    // Each cell is, at most, a move of the cursor ("\x1b[line;columnH") and the cell
+    char* text = (char*) malloc(2 * BUFFERSIZE + (size_t) 16 * size * size);
+    // Case malloc failed, print that malloc failed and abort execution
+    if(rows == NULL || text == NULL)
+        prompt_IO(ERROR_IO, "io.c, printShots(): malloc failed");
+    exportRows_Map(player->map, rows, false);
+
+    // The cursor is saved, moved to each line or cell to draw, and restored (back on the scrolling region)
+    char* p = text;
+    p += sprintf(p, "\x1b" "7");
+    // The cells are all drawn if the region has no map yet, or if moving the cursor to each cell changed is longer (with only one region, the maps of both players alternate on it)
+    int nr_changed = 0;
+    for(int i = 0; i < size * size; i++)
+        nr_changed += rows[i] != frame[i];
+    bool full = screen.id_players[r] == 0 || 8 * nr_changed > 2 * size * size;
+
+    if(screen.id_players[r] != id_player) {
+        p += sprintf(p, "\x1b[1;%dH%s", column, header);
+        screen.id_players[r] = id_player;
+    }
+    if(full) {
+        for(int x = 0; x < size; x++) {
+            p += sprintf(p, "\x1b[%d;%dH", x + 2, column);
+            for(int y = 0; y < size; y++) {
+                *p++ = shotChars[rows[x * size + y]];
+                *p++ = ' ';
+            }
+            p--;
+        }
+    }
+    else {
+        for(int i = 0; i < size * size; i++)
+            if(rows[i] != frame[i])
+                p += sprintf(p, "\x1b[%d;%dH%c", i / size + 2, column + 2 * (i % size), shotChars[rows[i]]);
+    }
+    memcpy(frame, rows, (size_t) size * size);
+    p += sprintf(p, "\x1b" "8");
+
+    fwrite(text, 1, p - text, stdout);
+    fflush(stdout);
+    free(rows);
+    free(text);
+}
+
+// Sink of the terminal: prints the events to stdout
+static void terminalEvent(Sink* sink, int identifier, va_list args)
+{
+    switch (identifier)
+    {
+        case ATTACK_RESULT_IO:
+        {
+            int attack_result = va_arg(args, int);
+
+            switch(attack_result) {
+                case -1: puts("[System] Attacked outside the map!"); break;
+                case  0: puts("[System] MISS!!!"); break;
+                case  1: puts("[System] HITTED A PIECE OF TYPE I!!!"); break;
+                case  2: puts("[System] HITTED A PIECE OF TYPE P!!!"); break;
+                case  3: puts("[System] HITTED A PIECE OF TYPE T!!!"); break;
+                case  4: puts("[System] HITTED A PIECE OF TYPE X!!!"); break;
+                case  5: puts("[System] HITTED A PIECE OF TYPE Z!!!"); break;
+                case  6: puts("[System] Attacked an piece already hitted!!!"); break;
+            }
+            break;
+        }
+
         // Prints the result of adding the piece
         case RESULT_ADDING_PIECE_IO:
         {
@@ -449,83 +685,43 @@ void prompt_IO(int identifier, ...)
             break;
         }
 
-        // Print the map of pieces. '.' for the see, 'B' for the pieces and 'X' for a piece destructed.
+        // Print the map of pieces. '.' for the see, the type for the pieces and 'X' for a piece destructed.
+        // The wait for the player to see it is a read (CONTINUE_IO), on the source.
         case PIECES_MAP_IO:
         {
-            char buffer[BUFFERSIZE];
-
             Player* player = va_arg(args, Player*);
 
             int id_player = va_arg(args, int);
             // Normalize the id.
             id_player++;
 
-            printf("[System] All pieces added.\n[System] Map of player %d.\n", id_player);
-
-            short p = 0;
-            for(int x = 0; x < player->map->size; x++) {
-                for(int y = 0; y < player->map->size; y++) {
-                    switch(getPieceStatus_Player(player, x, y)) {
-                        // Player doesn't have a piece in that position
-                        case 0: buffer[p++] = '.'; break;
-                        // Player has a piece in that position and isn't destroyed
-                        //case 1: buffer[p++] = player->map->cells[x][y]->piece->type; break;
-                        case 1: buffer[p++] = getPieceType_Player(player, x, y); break;
-                        // Player has a piece in that position and is destroyed
-                        case 2: buffer[p++] = 'X'; break;
-                    }
-                    buffer[p++] = ' ';
-                }
-                buffer[--p] = '\0';
-                puts(buffer);
-                p = 0;
-            }
-
-            printf("[System] Press enter...\n[Player%d] ", id_player);
-            while(!readInput(buffer));
-            system("clear");
+            char header[BUFFERSIZE];
+            snprintf(header, sizeof(header), "[System] All pieces added.\n[System] Map of player %d.\n", id_player);
+            printMap(player, true, header, "");
             break;
         }
 
+        // Print the map of shots. '.' for no shot, 'M' for a missed shot and the type of the piece for a shot on it.
         case SHOTS_MAP_IO:
         {
-            char buffer[BUFFERSIZE];
-
             Player* player = va_arg(args, Player*);
 
             int id_player = va_arg(args, int);
             // Normalize the id.
             id_player++;
 
-            printf("[System] Attack map of the player %d.\n", id_player);
-
-            short p = 0;
-            for(int x = 0; x < player->map->size; x++) {
-                for(int y = 0; y < player->map->size; y++) {
-                    switch(getShotStatus_Player(player, x, y)) {
-                        // Case of no shot
-                        case 0: buffer[p++] = '.'; break;
-                        // Case of a missed shot
-                        case 1: buffer[p++] = 'M'; break;
-                        // Case of a shot on a piece of type I
-                        case 2: buffer[p++] = 'I'; break;
-                        // Case of a shot on a piece of type P
-                        case 3: buffer[p++] = 'P'; break;
-                        // Case of a shot on a piece of type T
-                        case 4: buffer[p++] = 'T'; break;
-                        // Case of a shot on a piece of type X
-                        case 5: buffer[p++] = 'X'; break;
-                        // Case of a shot on a piece of type Z
-                        case 6: buffer[p++] = 'Z'; break;
-                    }
-                    buffer[p++] = ' ';
-                }
+            printShots(player, id_player);
+            break;
+        }
+
+        case SETUP_INFEASIBLE_IO:
+        {
+            int text_option = va_arg(args, int);
 
-                buffer[--p] = '\0';
-                puts(buffer);
-                p = 0;
+            switch(text_option) {
+                case false: puts("[System] The pieces can't all be placed in the map. Choose another setup.\n"); break;
+                case true: puts("[System] The pieces couldn't all be placed in the map. Generating another setup."); break;
             }
-            puts("");
             break;
         }
 
@@ -540,47 +736,162 @@ void prompt_IO(int identifier, ...)
             break;
         }
 
-        case PLAY_AGAIN_IO:
+        // Invalid identifier
+        default:
         {
-            char buffer[BUFFERSIZE];
+            prompt_IO(ERROR_IO, "io.c, terminalEvent(): invalid identifier");
+            break;
+        }
+    }
+}
 
-            // Pointer to the address where it's gonna be written the result of playing again.
-            bool* play_again = va_arg(args, bool*);
+// Returns true if the identifier is of an event (goes to a sink), false if it's of a read (comes from a source)
+static bool isEvent(int identifier)
+{
+    switch(identifier) {
+        case ATTACK_RESULT_IO:
+        case RESULT_ADDING_PIECE_IO:
+        case PIECES_MAP_IO:
+        case SHOTS_MAP_IO:
+        case SETUP_INFEASIBLE_IO:
+        case GAME_OVER_IO:
+            return true;
+        default:
+            return false;
+    }
+}
 
-            puts("[System] Thank you for playing!");
+static Sink terminal_sink = { terminalEvent, NULL };
+static Source terminal_source = { terminalRead, NULL };
 
-            bool valid = false;
-            do {
-                // Could read the input, properly
-                do
-                    printf("[System] Wanna play again? Write 'again' for playing again, or 'quit' to leave.\n[Player] ");
-                while(!readInput(buffer));
+Sink* terminal_Sink()
+{
+    return &terminal_sink;
+}
 
-                // Input verify the restriction
-                if(strcmp(buffer, "again") == 0 || strcmp(buffer, "a") == 0) {
-                    valid = true;
-                    *play_again = true;
-                    system("clear");
-                }
-                else if(strcmp(buffer, "quit") == 0 || strcmp(buffer, "q") == 0) {
-                    valid = true;
-                    *play_again = false;
-                    puts("[System] Hope you had fun!");
-                }
-                else
-                    puts("[System] Unknown command. Try again!\n");
-            } while(!valid);
+Source* terminal_Source()
+{
+    return &terminal_source;
+}
 
-            break;
-        }
+// Sink that ignores all the events
+static void nullEvent(Sink* sink, int identifier, va_list args)
+{
+}
 
-        // Invalid identifier
-        default:
-        {
-            prompt_IO(ERROR_IO, "io.c, prompt_IO(): invalid identifier");
-            break;
+static Sink null_sink = { nullEvent, NULL };
+
+Sink* null_Sink()
+{
+    return &null_sink;
+}
+
+// Source where no read can be answered, so every read notifies and aborts execution
+static void nullRead(Source* source, int identifier, va_list args)
+{
+    prompt_IO(ERROR_IO, "io.c, nullRead(): read on a game without a source");
+}
+
+static Source null_source = { nullRead, NULL };
+
+Source* null_Source()
+{
+    return &null_source;
+}
+
+// Source where the reads are answered by a function of the program
+typedef struct ProgrammaticSource
+{
+    Source base;
+    Reader reader;
+    void* context;
+} ProgrammaticSource;
+
+static void programmaticRead(Source* base, int identifier, va_list args)
+{
+    ProgrammaticSource* source = (ProgrammaticSource*) base;
+    source->reader(identifier, args, source->context);
+}
+
+static void freeProgrammatic(Source* source)
+{
+    free(source);
+}
+
+Source* newProgrammatic_Source(Reader reader, void* context)
+{
+    ProgrammaticSource* source = (ProgrammaticSource*) malloc(sizeof(ProgrammaticSource));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(source == NULL)
+        prompt_IO(ERROR_IO, "io.c, newProgrammatic_Source(): malloc failed");
+
+    source->base.read = programmaticRead;
+    source->base.freeSource = freeProgrammatic;
+    source->reader = reader;
+    source->context = context;
+    return &source->base;
+}
+
+// Sink of the errors, or NULL if they're printed on the terminal
+static Sink* error_sink = NULL;
+
+void setErrorSink_IO(Sink* sink)
+{
+    error_sink = sink;
+}
+
+void free_Sink(Sink* sink)
+{
+    // The sinks not allocated (terminal and null) have nothing to free, as the sources
+    if(sink->freeSink != NULL)
+        sink->freeSink(sink);
+}
+
+void free_Source(Source* source)
+{
+    if(source->freeSource != NULL)
+        source->freeSource(source);
+}
+
+void event_IO(Sink* sink, int identifier, ...)
+{
+    va_list args;
+    va_start(args, identifier);
+    sink->event(sink, identifier, args);
+    va_end(args);
+}
+
+void read_IO(Source* source, int identifier, ...)
+{
+    va_list args;
+    va_start(args, identifier);
+    source->read(source, identifier, args);
+    va_end(args);
+}
+
+void prompt_IO(int identifier, ...)
+{
+    va_list args;
+    va_start(args, identifier);
+
+    // The errors are printed on the terminal, or go to the sink of the errors, and abort execution
+    if(identifier == ERROR_IO) {
+        if(error_sink != NULL) {
+            // An error while writing the error is printed on the terminal
+            Sink* sink = error_sink;
+            error_sink = NULL;
+            sink->event(sink, ERROR_IO, args);
+        } else {
+            char* error_message = va_arg(args, char*);
+            puts(error_message);
         }
+        exit(EXIT_FAILURE);
     }
 
+    if(isEvent(identifier))
+        terminalEvent(&terminal_sink, identifier, args);
+    else
+        terminalRead(&terminal_source, identifier, args);
+
     va_end(args);
 }
@@ -1,13 +1,25 @@
 /*
     io.h
     Module that handles all of the IO activity of the game.
+
+    The IO is identified through an IDENTIFIER (enumerated and documented below), and is of two kinds:
+        - events, that only report something (ATTACK_RESULT_IO, RESULT_ADDING_PIECE_IO, PIECES_MAP_IO, SHOTS_MAP_IO, SETUP_INFEASIBLE_IO and GAME_OVER_IO),
+          which go to a sink;
+        - reads, that write the answer on their arguments (READ_RANDOMIZE_IO, READ_SETUP_IO, CONFIRM_SETUP_IO, ATTACK_COORDINATES_IO, READ_PIECE_IO, PLAY_AGAIN_IO
+          and CONTINUE_IO), which come from a source.
+    Only the sources read input: a sink never waits for the player.
+    The sinks and sources are pluggable (see below), with the terminal being the default of both. 
+    ERROR_IO is neither: it's printed on the terminal (or goes to the sink of the errors, see setErrorSink_IO) and aborts execution.
 */
 
 #ifndef IO_H
 #define IO_H
 
+#include <stdarg.h>
+#include <stdio.h>
+
 /* 
-    This function realizes the IO needed.
+    This function realizes the IO needed, on the terminal (or, for an event, on the sink of the terminal and, for a read, on the source of the terminal).
     The IO needed is identified through an IDENTIFIER (enumerated and documented below).
     For some identifiers, more arguments are needed. 
     This arguments vary and they are needed to get the information to print or where to read.
@@ -18,7 +30,7 @@ void prompt_IO(int identifier, ...);
 // List of the identifiers to the function prompt_IO
 enum IDENTIFIER {
     /* 
-        ERROR_IO: prints the string received and abort execution.     
+        ERROR_IO: prints the string received (or writes it on the sink of the errors, see setErrorSink_IO) and abort execution.
         Parameters: char* (address of the string to print)
      */
     ERROR_IO,
@@ -42,6 +54,12 @@ enum IDENTIFIER {
     */
     CONFIRM_SETUP_IO,
 
+    /*
+        SETUP_INFEASIBLE_IO: IO to print that the pieces of the setup couldn't all be placed in the map.
+        Parameters: bool (to change output text, false for the case of a choosen setup and true in case of a random setup)
+    */
+    SETUP_INFEASIBLE_IO,
+
     /*
         ATTACK_COORDINATES_IO: IO to read the attack coordinates
         Parameters: int (id player attacking), int* (address of the variable that holds the x coordinate of the attack) and int* (address of the variable that holds the y coordinate of the attack)
@@ -90,7 +108,126 @@ enum IDENTIFIER {
         PLAY_AGAIN_IO: IO to ask if the players want to play again.
         Parameters: bool* (address of the variable where it's gonna be written if it's to play again (true) or no (false))
     */
-    PLAY_AGAIN_IO
+    PLAY_AGAIN_IO,
+
+    /*
+        CONTINUE_IO: IO to wait for the player before going on, after the map of pieces of the player is shown (the terminal waits for enter, the other sources go on).
+        Parameters: int (the player's id)
+    */
+    CONTINUE_IO
 };
 
+/*
+    Definition of a sink: where the events go.
+    Each sink extends this struct with its own fields.
+*/
+typedef struct Sink
+{
+    // Handles the event 'identifier', with the arguments documented on the identifier
+    void (*event)(struct Sink* sink, int identifier, va_list args);
+
+    // Frees the sink (NULL if there's nothing to free)
+    void (*freeSink)(struct Sink* sink);
+} Sink;
+
+/*
+    Definition of a source: where the reads come from.
+    Each source extends this struct with its own fields.
+*/
+typedef struct Source
+{
+    // Answers the read 'identifier', writing on the arguments documented on the identifier
+    void (*read)(struct Source* source, int identifier, va_list args);
+
+    // Frees the source (NULL if there's nothing to free)
+    void (*freeSource)(struct Source* source);
+} Source;
+
+// Sends the event 'identifier', with its arguments, to the sink
+void event_IO(Sink* sink, int identifier, ...);
+
+// Asks the read 'identifier', with its arguments, to the source
+void read_IO(Source* source, int identifier, ...);
+
+// Sink that prints the events on the terminal (the default)
+Sink* terminal_Sink();
+
+// Sink that ignores all the events
+Sink* null_Sink();
+
+/*
+    Allocs a sink that writes the events on 'file' (opened for binary writing, and closed by whoever opened it), in a compact binary format:
+    one byte with the identifier, followed by the arguments of the event:
+        ATTACK_RESULT_IO:       one byte, with the result plus 1;
+        RESULT_ADDING_PIECE_IO: one byte, with the result;
+        SETUP_INFEASIBLE_IO:    one byte, with the text option;
+        GAME_OVER_IO:           one byte, with the id of the player;
+        PIECES_MAP_IO:          one byte with the id of the player, one byte with the size of the map and then the cells, row by row, 
+                                two cells per byte (4 bits each, the first cell on the lower bits), with 0 for no piece, 1 to 5 for the type of a piece not hitted 
+                                (I, P, T, X and Z, respectively) and 6 for a piece hitted;
+        SHOTS_MAP_IO:           as PIECES_MAP_IO, but each cell has its field 'shot' (0 to 6).
+*/
+Sink* newBinaryLog_Sink(FILE* file);
+
+// Source that reads from the terminal (the default)
+Source* terminal_Source();
+
+// Source without answers: any read notifies and aborts execution (instead of waiting for input that never comes)
+Source* null_Source();
+
+/*
+    Allocs a source that reads from 'file' (closed by whoever opened it), with one answer per line, without printing anything:
+        READ_RANDOMIZE_IO:     'random' (or 'r') or 'manual' (or 'm');
+        READ_SETUP_IO:         the map size, the number of pieces of type I, P, T, X and Z, and the first player attacking (1 or 2), separated by spaces;
+        CONFIRM_SETUP_IO:      'yes' (or 'y') or 'no' (or 'n');
+        ATTACK_COORDINATES_IO: the coordinates x and y, separated by a space (from 1 to the map size, as on the terminal);
+        READ_PIECE_IO:         the coordinates x and y and the degree of the rotation, separated by spaces;
+        PLAY_AGAIN_IO:         'again' (or 'a') or 'quit' (or 'q');
+        CONTINUE_IO:           no line (the script goes on).
+    Lines starting with '#' and empty lines are skipped. An invalid answer, or the end of the file, notifies and aborts execution.
+*/
+Source* newScripted_Source(FILE* file);
+
+/*
+    Protocol for engines (bots, test harnesses) that play through a pipe, in the spirit of UCI for chess engines: the game writes lines on 'out'
+    and reads the answers of the engine, one per line, on 'in'. The first line written is "protocol 1".
+    Before each read, the source writes a request, and the engine answers with one line, as on a script (see newScripted_Source):
+        ask randomize                           'random' (or 'r') or 'manual' (or 'm');
+        ask setup                               the map size, the number of pieces of type I, P, T, X and Z, and the first player attacking;
+        ask confirm <size> <I P T X Z> <first>  'yes' (or 'y') or 'no' (or 'n');
+        ask piece <player> <number> <type>      the coordinates x and y of the piece and the degree of the rotation;
+        ask attack <player>                     the coordinates x and y of the attack (from 1 to the map size);
+        ask again                               'again' (or 'a') or 'quit' (or 'q').
+    An answer that can't be read (or a setup or a rotation not allowed) gets the line "invalid", and the request is written again.
+    The events are written as (with the codes of registerAttack_Map and addPiece_Map, see map.h):
+        attack <result>                         ATTACK_RESULT_IO: -1 outside, 0 miss, 1 to 5 hit on I, P, T, X or Z, 6 already hitted;
+        piece <result>                          RESULT_ADDING_PIECE_IO: 0 added, 1 outside the map, 2 over another piece;
+        infeasible                              SETUP_INFEASIBLE_IO;
+        pieces <player> <size> <cells>          PIECES_MAP_IO: one digit per cell, row after row (as in exportRows_Map, with 'pieces' true);
+        over <player>                           GAME_OVER_IO.
+    SHOTS_MAP_IO isn't written (the engine has the results of the attacks), and CONTINUE_IO isn't asked. The players go from 1 to 2.
+    The lines are flushed only before each request, so a game is a few writes.
+    With the sink set as the sink of the errors (see setErrorSink_IO), an error (see ERROR_IO) is the line "error <message>", and the game ends.
+*/
+Sink* newProtocol_Sink(FILE* out);
+Source* newProtocol_Source(FILE* in, FILE* out);
+
+// Function of the program that answers the read 'identifier', writing on its arguments. 'context' is whatever was given with the function.
+typedef void (*Reader)(int identifier, va_list args, void* context);
+
+// Allocs a source where the reads are answered by the function 'reader'
+Source* newProgrammatic_Source(Reader reader, void* context);
+
+/*
+    Sets the sink where the errors (ERROR_IO) go, instead of the terminal, or NULL to print them on the terminal again (the default).
+    The sink must handle ERROR_IO as an event, with the string as its argument (as the protocol sink, see newProtocol_Sink).
+*/
+void setErrorSink_IO(Sink* sink);
+
+// Frees the sink
+void free_Sink(Sink* sink);
+
+// Frees the source
+void free_Source(Source* source);
+
 #endif
\ No newline at end of file
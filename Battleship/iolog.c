@@ -0,0 +1,88 @@
+#include "io.h"
+
+#include "player.h"
+#include <stdlib.h>
+
+// Sink that writes the events on a file, in binary (see io.h)
+typedef struct BinaryLogSink
+{
+    Sink base;
+    FILE* file;
+} BinaryLogSink;
+
+// Writes one byte on the file of the sink
+static void writeByte(BinaryLogSink* sink, int b)
+{
+    // Case the write failed, print that the write failed and abort execution
+    if(fputc(b, sink->file) == EOF)
+        prompt_IO(ERROR_IO, "iolog.c, writeByte(): write failed");
+}
+
+/*
+    Writes a map of a player: the id, the size and the cells, two per byte.
+    If 'pieces' is true, the values of the cells are of the pieces, otherwise of the shots (the same values as exportRows_Map, see map.h).
+    The map is exported at once, packed on one buffer and written with one fwrite.
+*/
+static void writeMap(BinaryLogSink* sink, Player* player, int id_player, bool pieces)
+{
+    int size = player->map->size;
+    int nr_cells = size * size, nr_bytes = (nr_cells + 1) / 2;
+    byte* rows = (byte*) malloc(nr_cells + 2 + nr_bytes);
+    // Case malloc failed, print that malloc failed and abort execution
+    if(rows == NULL)
+        prompt_IO(ERROR_IO, "iolog.c, writeMap(): malloc failed");
+    exportRows_Map(player->map, rows, pieces);
+
+    // The id and the size, then the cells, packed two per byte (the last byte may have only one cell)
+    byte* out = rows + nr_cells;
+    out[0] = id_player;
+    out[1] = size;
+    for(int i = 0; i < nr_bytes; i++)
+        out[2 + i] = rows[2 * i] | (2 * i + 1 < nr_cells ? rows[2 * i + 1] << 4 : 0);
+
+    // Case the write failed, print that the write failed and abort execution
+    if(fwrite(out, 1, 2 + nr_bytes, sink->file) != (size_t) (2 + nr_bytes))
+        prompt_IO(ERROR_IO, "iolog.c, writeMap(): write failed");
+    free(rows);
+}
+
+static void binaryLogEvent(Sink* base, int identifier, va_list args)
+{
+    BinaryLogSink* sink = (BinaryLogSink*) base;
+    writeByte(sink, identifier);
+
+    switch(identifier) {
+        case ATTACK_RESULT_IO: writeByte(sink, va_arg(args, int) + 1); break;
+        case RESULT_ADDING_PIECE_IO: writeByte(sink, va_arg(args, int)); break;
+        case SETUP_INFEASIBLE_IO: writeByte(sink, va_arg(args, int)); break;
+        case GAME_OVER_IO: writeByte(sink, va_arg(args, int)); break;
+        case PIECES_MAP_IO:
+        case SHOTS_MAP_IO:
+        {
+            Player* player = va_arg(args, Player*);
+            int id_player = va_arg(args, int);
+            writeMap(sink, player, id_player, identifier == PIECES_MAP_IO);
+            break;
+        }
+        // Case it isn't an event, notify and abort execution
+        default: prompt_IO(ERROR_IO, "iolog.c, binaryLogEvent(): invalid identifier");
+    }
+}
+
+static void freeBinaryLog(Sink* sink)
+{
+    free(sink);
+}
+
+Sink* newBinaryLog_Sink(FILE* file)
+{
+    BinaryLogSink* sink = (BinaryLogSink*) malloc(sizeof(BinaryLogSink));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(sink == NULL)
+        prompt_IO(ERROR_IO, "iolog.c, newBinaryLog_Sink(): malloc failed");
+
+    sink->base.event = binaryLogEvent;
+    sink->base.freeSink = freeBinaryLog;
+    sink->file = file;
+    return &sink->base;
+}
@@ -0,0 +1,287 @@
+#include "io.h"
+
+#include "player.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LINESIZE 256
+
+// Version of the protocol, written on the first line
+#define VERSION_PROTOCOL 1
+
+// Sink that writes the events as lines of the protocol (see io.h)
+typedef struct ProtocolSink
+{
+    Sink base;
+    FILE* out;
+} ProtocolSink;
+
+// Source that writes a request line for each read and reads the answer of the engine (see io.h)
+typedef struct ProtocolSource
+{
+    Source base;
+    FILE* in;
+    FILE* out;
+} ProtocolSource;
+
+static void protocolEvent(Sink* base, int identifier, va_list args)
+{
+    ProtocolSink* sink = (ProtocolSink*) base;
+
+    switch(identifier) {
+        // The codes are the ones of registerAttack_Map and addPiece_Map (see map.h)
+        case ATTACK_RESULT_IO: fprintf(sink->out, "attack %d\n", va_arg(args, int)); break;
+        case RESULT_ADDING_PIECE_IO: fprintf(sink->out, "piece %d\n", va_arg(args, int)); break;
+        case SETUP_INFEASIBLE_IO: va_arg(args, int); fputs("infeasible\n", sink->out); break;
+        // Normalize. Internally, players 1 and 2 are 0 and 1, respectively.
+        case GAME_OVER_IO: fprintf(sink->out, "over %d\n", va_arg(args, int) + 1); break;
+
+        // The map of pieces of a player, once the pieces are placed, with one digit per cell (as in exportRows_Map), row after row
+        case PIECES_MAP_IO:
+        {
+            Player* player = va_arg(args, Player*);
+            int id_player = va_arg(args, int);
+            int size = player->map->size;
+
+            char* line = (char*) malloc((size_t) size * size + 1);
+            // Case malloc failed, print that malloc failed and abort execution
+            if(line == NULL)
+                prompt_IO(ERROR_IO, "ioprotocol.c, protocolEvent(): malloc failed");
+            exportRows_Map(player->map, (byte*) line, true);
+            for(int i = 0; i < size * size; i++)
+                line[i] += '0';
+            line[size * size] = '\0';
+
+            fprintf(sink->out, "pieces %d %d %s\n", id_player + 1, size, line);
+            free(line);
+            break;
+        }
+
+        // The engine knows the shots of each player from the results of the attacks
+        case SHOTS_MAP_IO: break;
+
+        // As the sink of the errors (see setErrorSink_IO), the message goes on a line of its own, written before execution is aborted
+        case ERROR_IO: fprintf(sink->out, "error %s\n", va_arg(args, char*)); break;
+
+        // Case it isn't an event, notify and abort execution
+        default: prompt_IO(ERROR_IO, "ioprotocol.c, protocolEvent(): invalid identifier");
+    }
+}
+
+// Writes the request line, and reads the answer to 'buffer' (without the '\n'). If the input ends, notifies and aborts execution.
+static void ask(ProtocolSource* source, const char* request, char buffer[LINESIZE])
+{
+    fprintf(source->out, "ask %s\n", request);
+    // The engine only answers after the request is read, so everything written till now goes with it
+    fflush(source->out);
+
+    if(fgets(buffer, LINESIZE, source->in) == NULL)
+        prompt_IO(ERROR_IO, "[System] The input of the protocol ended.");
+    buffer[strcspn(buffer, "\r\n")] = '\0';
+}
+
+// Returns 1 if the answer is the first word (or its first letter), 0 if it's the second, and -1 if it's neither
+static int parseChoice(const char* buffer, const char* first, const char* second)
+{
+    if(strcmp(buffer, first) == 0 || (buffer[0] == first[0] && buffer[1] == '\0'))
+        return 1;
+    if(strcmp(buffer, second) == 0 || (buffer[0] == second[0] && buffer[1] == '\0'))
+        return 0;
+    return -1;
+}
+
+// Parses exactly 'count' integers to 'numbers'. Returns false if the answer has anything else.
+static bool parseNumbers(const char* buffer, int count, int* numbers)
+{
+    const char* p = buffer;
+    for(int i = 0; i < count; i++) {
+        char* end;
+        long number = strtol(p, &end, 10);
+        if(end == p)
+            return false;
+        numbers[i] = (int) number;
+        p = end;
+    }
+
+    // Nothing but spaces after the numbers
+    while(*p == ' ' || *p == '\t')
+        p++;
+    return *p == '\0';
+}
+
+// Asks till the answer is one of the two words, writing 'invalid' after each answer that isn't: returns true for the first and false for the second
+static bool askChoice(ProtocolSource* source, const char* request, const char* first, const char* second)
+{
+    char buffer[LINESIZE];
+    while(true) {
+        ask(source, request, buffer);
+        int choice = parseChoice(buffer, first, second);
+        if(choice >= 0)
+            return choice == 1;
+        fputs("invalid\n", source->out);
+    }
+}
+
+// Asks till the answer has exactly 'count' integers, writing 'invalid' after each answer that hasn't
+static void askNumbers(ProtocolSource* source, const char* request, int count, int* numbers)
+{
+    char buffer[LINESIZE];
+    while(true) {
+        ask(source, request, buffer);
+        if(parseNumbers(buffer, count, numbers))
+            return;
+        fputs("invalid\n", source->out);
+    }
+}
+
+static void protocolRead(Source* base, int identifier, va_list args)
+{
+    ProtocolSource* source = (ProtocolSource*) base;
+    char request[LINESIZE];
+
+    switch(identifier) {
+        case READ_RANDOMIZE_IO:
+        {
+            bool* p_randomize = va_arg(args, bool*);
+            *p_randomize = askChoice(source, "randomize", "random", "manual");
+            break;
+        }
+
+        case READ_SETUP_IO:
+        {
+            int* p_map_size = va_arg(args, int*);
+            int* p_nr_per_piece = va_arg(args, int*);
+            int* p_player_attacking = va_arg(args, int*);
+
+            // Same restrictions of the terminal: size between 20 and 40, at most size * size / 25 pieces, and player 1 or 2
+            int numbers[7];
+            while(true) {
+                askNumbers(source, "setup", 7, numbers);
+                int nr_pieces = 0;
+                bool valid = numbers[0] >= 20 && numbers[0] <= 40 && (numbers[6] == 1 || numbers[6] == 2);
+                for(int i = 0; i < 5; i++) {
+                    valid = valid && numbers[1 + i] >= 0;
+                    nr_pieces += numbers[1 + i];
+                }
+                if(valid && nr_pieces <= numbers[0] * numbers[0] / 25)
+                    break;
+                fputs("invalid\n", source->out);
+            }
+
+            *p_map_size = numbers[0];
+            for(int i = 0; i < 5; i++)
+                p_nr_per_piece[i] = numbers[1 + i];
+            //Normalize. Internally, players 1 and 2 are 0 and 1, respectively.
+            *p_player_attacking = numbers[6] - 1;
+            break;
+        }
+
+        case CONFIRM_SETUP_IO:
+        {
+            int map_size = va_arg(args, int);
+            int* p_nr_per_piece = va_arg(args, int*);
+            int first_player_attacking = va_arg(args, int);
+            bool* p_confirmed = va_arg(args, bool*);
+
+            snprintf(request, sizeof(request), "confirm %d %d %d %d %d %d %d", map_size, p_nr_per_piece[0], p_nr_per_piece[1],
+                     p_nr_per_piece[2], p_nr_per_piece[3], p_nr_per_piece[4], first_player_attacking + 1);
+            *p_confirmed = askChoice(source, request, "yes", "no");
+            break;
+        }
+
+        case ATTACK_COORDINATES_IO:
+        {
+            int id_player = va_arg(args, int);
+            int* p_x = va_arg(args, int*);
+            int* p_y = va_arg(args, int*);
+
+            // The coordinates aren't checked: an attack outside the map has its own result (-1)
+            int numbers[2];
+            snprintf(request, sizeof(request), "attack %d", id_player + 1);
+            askNumbers(source, request, 2, numbers);
+
+            // Normalize. Internally, the coordinates of the map go from 0 to (game->size - 1).
+            *p_x = numbers[0] - 1;
+            *p_y = numbers[1] - 1;
+            break;
+        }
+
+        case READ_PIECE_IO:
+        {
+            int id_player = va_arg(args, int);
+            int nr_piece = va_arg(args, int);
+            int type = va_arg(args, int);
+            int* p_x = va_arg(args, int*);
+            int* p_y = va_arg(args, int*);
+            int* p_r = va_arg(args, int*);
+
+            int numbers[3];
+            snprintf(request, sizeof(request), "piece %d %d %c", id_player + 1, nr_piece, type);
+            while(true) {
+                askNumbers(source, request, 3, numbers);
+                if(numbers[2] >= 0 && numbers[2] <= 360 && numbers[2] % 90 == 0)
+                    break;
+                fputs("invalid\n", source->out);
+            }
+
+            *p_x = numbers[0] - 1;
+            *p_y = numbers[1] - 1;
+            // 360 is the same rotation as 0
+            *p_r = numbers[2] % 360;
+            break;
+        }
+
+        case PLAY_AGAIN_IO:
+        {
+            bool* p_play_again = va_arg(args, bool*);
+            *p_play_again = askChoice(source, "again", "again", "quit");
+            break;
+        }
+
+        // The engine doesn't need to look at the map, so it isn't asked
+        case CONTINUE_IO: va_arg(args, int); break;
+
+        // Case it isn't a read, notify and abort execution
+        default: prompt_IO(ERROR_IO, "ioprotocol.c, protocolRead(): invalid identifier");
+    }
+}
+
+static void freeProtocolSink(Sink* sink)
+{
+    fflush(((ProtocolSink*) sink)->out);
+    free(sink);
+}
+
+static void freeProtocolSource(Source* source)
+{
+    free(source);
+}
+
+Sink* newProtocol_Sink(FILE* out)
+{
+    ProtocolSink* sink = (ProtocolSink*) malloc(sizeof(ProtocolSink));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(sink == NULL)
+        prompt_IO(ERROR_IO, "ioprotocol.c, newProtocol_Sink(): malloc failed");
+
+    sink->base.event = protocolEvent;
+    sink->base.freeSink = freeProtocolSink;
+    sink->out = out;
+    fprintf(out, "protocol %d\n", VERSION_PROTOCOL);
+    return &sink->base;
+}
+
+Source* newProtocol_Source(FILE* in, FILE* out)
+{
+    ProtocolSource* source = (ProtocolSource*) malloc(sizeof(ProtocolSource));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(source == NULL)
+        prompt_IO(ERROR_IO, "ioprotocol.c, newProtocol_Source(): malloc failed");
+
+    source->base.read = protocolRead;
+    source->base.freeSource = freeProtocolSource;
+    source->in = in;
+    source->out = out;
+    return &source->base;
+}
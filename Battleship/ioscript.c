@@ -0,0 +1,199 @@
+#include "io.h"
+
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LINESIZE 256
+
+// Source that reads the answers from a file, one per line (see io.h)
+typedef struct ScriptedSource
+{
+    Source base;
+    FILE* file;
+
+    // Number of the last line read, to show on errors
+    int line;
+} ScriptedSource;
+
+// Notifies that the answer of the current line is invalid and aborts execution
+static void invalidAnswer(ScriptedSource* source, const char* expected)
+{
+    char message[LINESIZE];
+    snprintf(message, sizeof(message), "[System] Invalid answer on line %d of the script: expected %s.", source->line, expected);
+    prompt_IO(ERROR_IO, message);
+}
+
+// Reads the next line with an answer to 'buffer', without the '\n'. If the file ends, notifies and aborts execution.
+static void nextLine(ScriptedSource* source, char buffer[LINESIZE], const char* expected)
+{
+    do {
+        if(fgets(buffer, LINESIZE, source->file) == NULL) {
+            char message[LINESIZE];
+            snprintf(message, sizeof(message), "[System] The script ended: expected %s.", expected);
+            prompt_IO(ERROR_IO, message);
+        }
+        source->line++;
+        buffer[strcspn(buffer, "\r\n")] = '\0';
+    } while(buffer[0] == '\0' || buffer[0] == '#');
+}
+
+// Reads a line with one of two words (each with its short form): returns true for the first and false for the second
+static bool readChoice(ScriptedSource* source, const char* first, const char* second, const char* expected)
+{
+    char buffer[LINESIZE];
+    nextLine(source, buffer, expected);
+
+    if(strcmp(buffer, first) == 0 || (buffer[0] == first[0] && buffer[1] == '\0'))
+        return true;
+    if(strcmp(buffer, second) == 0 || (buffer[0] == second[0] && buffer[1] == '\0'))
+        return false;
+
+    invalidAnswer(source, expected);
+    return false;
+}
+
+// Reads a line with exactly 'count' integers to 'numbers'
+static void readNumbers(ScriptedSource* source, int count, int* numbers, const char* expected)
+{
+    char buffer[LINESIZE];
+    nextLine(source, buffer, expected);
+
+    char* p = buffer;
+    for(int i = 0; i < count; i++) {
+        char* end;
+        long number = strtol(p, &end, 10);
+        if(end == p)
+            invalidAnswer(source, expected);
+        numbers[i] = (int) number;
+        p = end;
+    }
+
+    // Nothing but spaces after the numbers
+    while(*p == ' ' || *p == '\t')
+        p++;
+    if(*p != '\0')
+        invalidAnswer(source, expected);
+}
+
+static void scriptedRead(Source* base, int identifier, va_list args)
+{
+    ScriptedSource* source = (ScriptedSource*) base;
+
+    switch(identifier) {
+        case READ_RANDOMIZE_IO:
+        {
+            bool* p_randomize = va_arg(args, bool*);
+            *p_randomize = readChoice(source, "random", "manual", "'random' or 'manual'");
+            break;
+        }
+
+        case READ_SETUP_IO:
+        {
+            int* p_map_size = va_arg(args, int*);
+            int* p_nr_per_piece = va_arg(args, int*);
+            int* p_player_attacking = va_arg(args, int*);
+
+            int numbers[7];
+            const char* expected = "the map size (20 to 40), the number of pieces of each type and the first player attacking (1 or 2)";
+            readNumbers(source, 7, numbers, expected);
+
+            // Same restrictions of the terminal: size between 20 and 40, at most size * size / 25 pieces, and player 1 or 2
+            int nr_pieces = 0;
+            for(int i = 0; i < 5; i++) {
+                if(numbers[1 + i] < 0)
+                    invalidAnswer(source, expected);
+                nr_pieces += numbers[1 + i];
+            }
+            if(numbers[0] < 20 || numbers[0] > 40 || nr_pieces > numbers[0] * numbers[0] / 25 || (numbers[6] != 1 && numbers[6] != 2))
+                invalidAnswer(source, expected);
+
+            *p_map_size = numbers[0];
+            for(int i = 0; i < 5; i++)
+                p_nr_per_piece[i] = numbers[1 + i];
+            //Normalize. Internally, players 1 and 2 are 0 and 1, respectively.
+            *p_player_attacking = numbers[6] - 1;
+            break;
+        }
+
+        case CONFIRM_SETUP_IO:
+        {
+            // The setup (map size, pieces and first player) isn't needed to answer
+            va_arg(args, int);
+            va_arg(args, int*);
+            va_arg(args, int);
+            bool* p_confirmed = va_arg(args, bool*);
+            *p_confirmed = readChoice(source, "yes", "no", "'yes' or 'no'");
+            break;
+        }
+
+        case ATTACK_COORDINATES_IO:
+        {
+            va_arg(args, int);
+            int* p_x = va_arg(args, int*);
+            int* p_y = va_arg(args, int*);
+
+            int numbers[2];
+            readNumbers(source, 2, numbers, "the coordinates x and y of the attack");
+
+            // Normalize. Internally, the coordinates of the map go from 0 to (game->size - 1).
+            *p_x = numbers[0] - 1;
+            *p_y = numbers[1] - 1;
+            break;
+        }
+
+        case READ_PIECE_IO:
+        {
+            va_arg(args, int);
+            va_arg(args, int);
+            va_arg(args, int);
+            int* p_x = va_arg(args, int*);
+            int* p_y = va_arg(args, int*);
+            int* p_r = va_arg(args, int*);
+
+            int numbers[3];
+            const char* expected = "the coordinates x and y of the piece and the degree of the rotation (0, 90, 180, 270 or 360)";
+            readNumbers(source, 3, numbers, expected);
+            if(numbers[2] < 0 || numbers[2] > 360 || numbers[2] % 90 != 0)
+                invalidAnswer(source, expected);
+
+            *p_x = numbers[0] - 1;
+            *p_y = numbers[1] - 1;
+            // 360 is the same rotation as 0
+            *p_r = numbers[2] % 360;
+            break;
+        }
+
+        case PLAY_AGAIN_IO:
+        {
+            bool* p_play_again = va_arg(args, bool*);
+            *p_play_again = readChoice(source, "again", "quit", "'again' or 'quit'");
+            break;
+        }
+
+        // There's no one to wait for, so there's no line
+        case CONTINUE_IO: va_arg(args, int); break;
+
+        // Case it isn't a read, notify and abort execution
+        default: prompt_IO(ERROR_IO, "ioscript.c, scriptedRead(): invalid identifier");
+    }
+}
+
+static void freeScripted(Source* source)
+{
+    free(source);
+}
+
+Source* newScripted_Source(FILE* file)
+{
+    ScriptedSource* source = (ScriptedSource*) malloc(sizeof(ScriptedSource));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(source == NULL)
+        prompt_IO(ERROR_IO, "ioscript.c, newScripted_Source(): malloc failed");
+
+    source->base.read = scriptedRead;
+    source->base.freeSource = freeScripted;
+    source->file = file;
+    source->line = 0;
+    return &source->base;
+}
@@ -0,0 +1,168 @@
+#include "linquadtree.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "io.h"
+
+// Bits of the code that belong to x and to y, respectively
+#define X_BITS 0x55555555u
+#define Y_BITS 0xAAAAAAAAu
+
+// Spreads the 16 bits of v to the even bits of the result
+static uint32_t spread(uint32_t v)
+{
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+// Inverse of spread: joins the even bits of v
+static uint32_t compact(uint32_t v)
+{
+    v &= 0x55555555;
+    v = (v | (v >> 1)) & 0x33333333;
+    v = (v | (v >> 2)) & 0x0F0F0F0F;
+    v = (v | (v >> 4)) & 0x00FF00FF;
+    v = (v | (v >> 8)) & 0x0000FFFF;
+    return v;
+}
+
+// Returns the Morton code of (x,y)
+static uint32_t morton(int x, int y)
+{
+    return spread(x) | (spread(y) << 1);
+}
+
+// Returns the position of the first node, between the positions 'from' and 'nr_nodes', with a code greater or equal to 'code'.
+static int lowerBound(LinearQuadTree* lqt, int from, uint32_t code)
+{
+    int lo = from, hi = lqt->nr_nodes;
+    while(lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if(lqt->nodes[mid].code < code) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/*
+  Returns the smallest code, bigger than 'code', inside the rectangle with codes from 'zmin' (upper corner) to 'zmax' (bottom corner).
+  'code' must be between 'zmin' and 'zmax', but outside the rectangle.
+  It's the BIGMIN of Tropf and Herzog: the bits are compared from the most significant to the less significant,
+  cutting the rectangle in half, along the dimension of the bit, till the half where the answer is, is found.
+*/
+static uint32_t bigmin(uint32_t code, uint32_t zmin, uint32_t zmax)
+{
+    uint32_t result = 0;
+    for(int bit = 31; bit >= 0; bit--) {
+        uint32_t mask = (uint32_t) 1 << bit;
+        // The bits, less significant than 'bit', of the same dimension of 'bit'
+        uint32_t lower = ((bit % 2 == 0) ? X_BITS : Y_BITS) & (mask - 1);
+
+        int c = (code & mask) != 0, min = (zmin & mask) != 0, max = (zmax & mask) != 0;
+        if(!c && !min && max) {
+            // The answer is on the lower half, or is the first code of the upper half
+            result = (zmin | mask) & ~lower;
+            zmax = (zmax & ~mask) | lower;
+        }
+        else if(!c && min && max)
+            // The whole rectangle is after the code
+            return zmin;
+        else if(c && !min && !max)
+            // The whole rectangle is before the code
+            return result;
+        else if(c && !min && max)
+            // The answer is on the upper half
+            zmin = (zmin | mask) & ~lower;
+        // In the other cases, the three agree on the bit and we go on to the next one
+    }
+    return result;
+}
+
+LinearQuadTree* new_LinearQuadTree()
+{
+    LinearQuadTree* lqt = (LinearQuadTree*) malloc(sizeof(LinearQuadTree));
+    if(lqt == NULL)
+        prompt_IO(ERROR_IO, "linquadtree.c, new_LinearQuadTree(): malloc failed");
+
+    lqt->nodes = NULL;
+    lqt->nr_nodes = lqt->capacity = 0;
+
+    return lqt;
+}
+
+Cell* insert_LinearQuadTree(LinearQuadTree* lqt, int x, int y)
+{
+    uint32_t code = morton(x, y);
+    int p = lowerBound(lqt, 0, code);
+
+    // Case it exists
+    if(p < lqt->nr_nodes && lqt->nodes[p].code == code)
+        return &lqt->nodes[p].cell;
+
+    if(lqt->nr_nodes == lqt->capacity) {
+        lqt->capacity = (lqt->capacity == 0) ? 64 : 2 * lqt->capacity;
+        lqt->nodes = (LinearNode*) realloc(lqt->nodes, lqt->capacity * sizeof(LinearNode));
+        if(lqt->nodes == NULL)
+            prompt_IO(ERROR_IO, "linquadtree.c, insert_LinearQuadTree(): realloc failed");
+    }
+
+    // Open space for the new node, keeping the array sorted
+    memmove(&lqt->nodes[p + 1], &lqt->nodes[p], (lqt->nr_nodes - p) * sizeof(LinearNode));
+    lqt->nr_nodes++;
+
+    lqt->nodes[p].code = code;
+    init_Cell(&lqt->nodes[p].cell);
+    return &lqt->nodes[p].cell;
+}
+
+Cell* search_LinearQuadTree(LinearQuadTree* lqt, int x, int y)
+{
+    uint32_t code = morton(x, y);
+    int p = lowerBound(lqt, 0, code);
+
+    if(p < lqt->nr_nodes && lqt->nodes[p].code == code)
+        return &lqt->nodes[p].cell;
+    return NULL;
+}
+
+bool hasCell_LinearQuadTree(LinearQuadTree* lqt, int x, int y)
+{
+    return search_LinearQuadTree(lqt, x, y) != NULL;
+}
+
+void visit_LinearQuadTree(LinearQuadTree* lqt, int x1, int y1, int x2, int y2, CellVisitor visitor, void* context)
+{
+    // Clip the rectangle to the coordinates that may exist
+    if(x1 < 0) x1 = 0;
+    if(y1 < 0) y1 = 0;
+    if(x1 > x2 || y1 > y2)
+        return;
+
+    uint32_t zmin = morton(x1, y1), zmax = morton(x2, y2);
+
+    int p = lowerBound(lqt, 0, zmin);
+    while(p < lqt->nr_nodes && lqt->nodes[p].code <= zmax) {
+        uint32_t code = lqt->nodes[p].code;
+        int x = compact(code), y = compact(code >> 1);
+
+        // Inside the rectangle
+        if(x >= x1 && x <= x2 && y >= y1 && y <= y2) {
+            if(!visitor(&lqt->nodes[p].cell, x, y, context))
+                return;
+            p++;
+        }
+        // Outside: jump to the next code inside the rectangle
+        else
+            p = lowerBound(lqt, p + 1, bigmin(code, zmin, zmax));
+    }
+}
+
+void free_LinearQuadTree(LinearQuadTree* lqt)
+{
+    free(lqt->nodes);
+    free(lqt);
+}
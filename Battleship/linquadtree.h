@@ -0,0 +1,56 @@
+/*
+  linquadtree.h
+  Representation of a linear quadtree.
+
+  Instead of the regions being nodes connected by pointers, only the points with a cell are stored,
+  in an array sorted by the Z-order (Morton) code of (x,y), that is, the number whose bits are the bits of x and y interleaved (x on the even bits and y on the odd bits).
+  Sorting by this code is the same as going through the leaves of the quadtree (of quadtree.h) from left to right,
+  so each region of the quadtree is a range of the array and the memory used is only proportional to the number of cells.
+*/
+
+#ifndef LINQUADTREE_H
+#define LINQUADTREE_H
+
+#include <stdint.h>
+#include "cell.h"
+
+typedef struct LinearNode {
+  // Morton code of the (x,y)
+  uint32_t code;
+  // The data on the position (x,y)
+  Cell cell;
+} LinearNode;
+
+typedef struct LinearQuadTree {
+  // Nodes, sorted by the code
+  LinearNode* nodes;
+  // Number of nodes and space allocated for nodes
+  int nr_nodes, capacity;
+} LinearQuadTree;
+
+// Allocs a new linear quadtree. The coordinates of the points must be between 0 and 65535, inclusive.
+LinearQuadTree* new_LinearQuadTree();
+
+/*
+  Returns the cell of the point (x,y). If it doesn't exist, a node is inserted for it, with the field piece set to NULL and the field shot to 0.
+  NOTE: The cells move when nodes are inserted, so the pointers returned are only valid till the next insertion.
+*/
+Cell* insert_LinearQuadTree(LinearQuadTree* lqt, int x, int y);
+
+// Search the linear quadtree for the point (x,y), with a binary search. If found, returns the cell of the node, otherwise returns NULL.
+Cell* search_LinearQuadTree(LinearQuadTree* lqt, int x, int y);
+
+// Returns true if exists a node, representing the point (x,y). Otherwise, returns false.
+bool hasCell_LinearQuadTree(LinearQuadTree* lqt, int x, int y);
+
+/*
+  Calls the visitor for each cell in the rectangle with upper corner (x1,y1) and bottom corner (x2,y2), inclusive, in Z-order,
+  till there are no more cells or the visitor returns false.
+  Only the range of codes of the rectangle is scanned and, when the scan leaves the rectangle, it jumps directly to the next code inside it.
+*/
+void visit_LinearQuadTree(LinearQuadTree* lqt, int x1, int y1, int x2, int y2, CellVisitor visitor, void* context);
+
+// Frees the linear quadtree and all the memory allocated in it.
+void free_LinearQuadTree(LinearQuadTree* lqt);
+
+#endif
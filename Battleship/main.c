@@ -1,13 +1,113 @@
 #include "game.h"
 
-int main(void) 
+#include "options.h"
+#include "io.h"
+#include "density.h"
+#include "montecarlo.h"
+#include "scheduler.h"
+#include "record.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*
+    Opens the file of the option 'name' (with the mode 'mode'), or returns NULL if the option isn't given.
+    If the file can't be opened, notifies and aborts execution.
+*/
+static FILE* openOption(int argc, char* argv[], const char* name, const char* mode)
+{
+    const char* path = get_Options(argc, argv, name, NULL);
+    if(path == NULL)
+        return NULL;
+
+    FILE* file = fopen(path, mode);
+    if(file == NULL) {
+        char message[256];
+        snprintf(message, sizeof(message), "[System] The file '%s' of the option --%s can't be opened.", path, name);
+        prompt_IO(ERROR_IO, message);
+    }
+    return file;
+}
+
+int main(int argc, char* argv[]) 
 {  
+    // Backend of the maps, and seed of the random setups: with the option '--seed <n>' (or the environment variable BATTLESHIP_SEED),
+    // or, if it isn't given, based on the current time of the system.
+    chooseBackend_Options(argc, argv);
+    uint64_t seed = getNumber_Options(argc, argv, "seed", "BATTLESHIP_SEED", (uint64_t) time(NULL));
+
+    // Where the events go: the terminal, or, with '--log <file>', a binary log, or, with '--quiet 1', nowhere.
+    // Where the reads come from: the terminal, or, with '--script <file>', the answers on the file.
+    // With '--protocol 1', both go through the protocol for engines (see io.h), on stdin and stdout.
+    FILE* log = openOption(argc, argv, "log", "wb");
+    FILE* script = openOption(argc, argv, "script", "r");
+    bool protocol = getNumber_Options(argc, argv, "protocol", NULL, 0) != 0;
+    Sink* sink = protocol ? newProtocol_Sink(stdout) : log != NULL ? newBinaryLog_Sink(log) : getNumber_Options(argc, argv, "quiet", NULL, 0) != 0 ? null_Sink() : terminal_Sink();
+    Source* source = protocol ? newProtocol_Source(stdin, stdout) : script != NULL ? newScripted_Source(script) : terminal_Source();
+    // On the protocol, the errors are lines of the protocol too, so the engine can read them
+    if(protocol)
+        setErrorSink_IO(sink);
+
+    // With '--record <file>', all the games played are recorded on the file (see record.h)
+    FILE* record_file = openOption(argc, argv, "record", "wb");
+    Record* record = NULL;
+    if(record_file != NULL) {
+        writeMagic_Record(record_file);
+        record = new_Record();
+    }
+
+    // With '--computer 1' (or 2), that player is played by the program: by density (see density.h) or, with '--ai montecarlo', 
+    // by Monte Carlo (see montecarlo.h), on all the processors, with '--budget <n>' microseconds per attack (default 100000)
+    int computer = (int) getNumber_Options(argc, argv, "computer", NULL, 0);
+    if(computer > 2)
+        prompt_IO(ERROR_IO, "[System] The player of the computer must be 1 or 2.");
+    const char* ai = get_Options(argc, argv, "ai", NULL);
+    bool montecarlo = ai != NULL && strcmp(ai, "montecarlo") == 0;
+    if(ai != NULL && !montecarlo && strcmp(ai, "density") != 0)
+        prompt_IO(ERROR_IO, "[System] Unknown ai. The ais are 'density' and 'montecarlo'.");
+    double budget = getNumber_Options(argc, argv, "budget", NULL, 100000) * 1e-6;
+    int nr_threads = processors_Scheduler();
+    if(nr_threads > MAX_THREADS_MONTECARLO)
+        nr_threads = MAX_THREADS_MONTECARLO;
+
     Game* game;
     do {
-        game = init_Game();
+        // Each game played gets the next seed, so playing again doesn't repeat the setup
+        game = init_Game(seed++, sink, source);
+        if(record != NULL)
+            setRecord_Game(game, record);
+
+        void* bot = NULL;
+        if(computer != 0 && montecarlo) {
+            bot = new_MonteCarlo(game->players[computer % 2], &game->random, nr_threads, budget, 0);
+            setAttacker_Game(game, computer - 1, attack_MonteCarlo, bot);
+        } else if(computer != 0) {
+            bot = new_Density(game->players[computer % 2], &game->random);
+            setAttacker_Game(game, computer - 1, attack_Density, bot);
+        }
+
         do
             playTurn_Game(game);
         while(!over_Game(game));
+        if(record != NULL)
+            write_Record(record, record_file);
+
+        if(bot != NULL && montecarlo)
+            free_MonteCarlo((MonteCarlo*) bot);
+        else if(bot != NULL)
+            free_Density((Density*) bot);
     } while(!exit_Game(game));
+
+    setErrorSink_IO(NULL);
+    free_Sink(sink);
+    free_Source(source);
+    if(log != NULL)
+        fclose(log);
+    if(script != NULL)
+        fclose(script);
+    if(record != NULL) {
+        free_Record(record);
+        fclose(record_file);
+    }
     return 0;
 }
@@ -1,336 +1,243 @@
 #include "map.h"
 
+#include "mapbackend.h"
 #include "utils.h"
 #include "io.h"
-#include <stdlib.h>
+#include <string.h>
 
-#ifdef MATRIX
+// All the backends, the first one being the default
+static const MapBackend* backends[] = { &quadtreeBackend, &matrixBackend, &bitboardBackend, &linearBackend, &adaptiveBackend };
 
-/*
-    Function that see's if a piece can be added to the map.
-    If it returns 0, than the piece can be added.
-    If it returns 1, than (parts of) the piece would be outside the map
-    If it returns 2, than (parts of) the piece would intersect with previous pieces, that is, there is already a (at least one) piece (or parts of), where this piece lies.
-    Note: Nothing to the map happens, in all the cases.
-*/
-static int canAddPiece(Map* map, Piece* piece)
-{
-    /*
-        Check if the attack is inside the map.
-        Note: Check this first. or the next call made 'getStatus_Piece', may cause a segmentation fault.
-    */
-    if(piece->posX < 0 || piece->posX >= map->size || piece->posY < 0 || piece->posY >= map->size )
-        return 1;
+// Backend of the maps allocated from now on
+static const MapBackend* current_backend = &quadtreeBackend;
 
-    for(int x = piece->posX - 2; x <= piece->posX + 2; x++) {
-        for(int y = piece->posY - 2; y <= piece->posY + 2; y++) {
-            // For the positions (x,y) that we need to attactch the piece, we need to see if:
-            if(getStatus_Piece(piece, x, y) == 1) {
-                // it's a valid position on the map
-                if(x < 0 || x >= map->size || y < 0 || y >= map->size)
-                    return 1;
-                // and there's a piece there already.
-                if(map->cells[x][y]->piece != NULL)
-                    return 2;
-            }
+bool setBackend_Map(const char* name)
+{
+    for(int i = 0; i < (int) (sizeof(backends) / sizeof(backends[0])); i++) {
+        if(strcmp(backends[i]->name, name) == 0) {
+            current_backend = backends[i];
+            return true;
         }
     }
-    // At this point, we know that the piece can be attactched
-    return 0;
+    return false;
 }
 
-// Simple function to attactch the piece to the map.
-static void attactchPiece(Map* map, Piece* piece)
+const char* getBackend_Map()
 {
-    for(int i = piece->posX - 2; i <= piece->posX + 2; i++)
-        for(int j = piece->posY - 2; j <= piece->posY + 2; j++)
-            if(getStatus_Piece(piece, i, j) == 1)
-                map->cells[i][j]->piece = piece;
+    return current_backend->name;
 }
 
+// Returns true if (x,y) is inside the map
+static bool inside(Map* map, int x, int y)
+{
+    return x >= 0 && x < map->size && y >= 0 && y < map->size;
+}
 
-Map* new_Map(int map_size)
+Map* new_Map(int size, Piece* pieces)
 {
-    Map* map = (Map*) malloc(sizeof(Map));
-    // Case malloc failed, print that malloc failed and abort execution
-    if(map == NULL)
-        prompt_IO(ERROR_IO, "map.c, new_Map(): first malloc failed");
-
-    // Update size of the map
-    map->size = map_size;
-
-    map->cells = (Cell***) malloc(map->size * sizeof(Cell**));
-    // Case malloc failed, print that malloc failed and abort execution
-    if(map->cells == NULL)
-        prompt_IO(ERROR_IO, "map.c, new_Map(): second malloc failed");
-
-    for(int x = 0; x < map->size; x++) {
-        map->cells[x] = (Cell**) malloc(map->size * sizeof(Cell*));
-        // Case malloc failed, print that malloc failed and abort execution
-        if(map->cells[x] == NULL)
-            prompt_IO(ERROR_IO, "map.c, new_Map(): third malloc failed");
-
-        for(int y = 0; y < map->size; y++)
-            map->cells[x][y] = new_Cell();
-    }
+    Map* map = current_backend->newMap(size, pieces);
+    map->backend = current_backend;
     return map;
 }
 
+/*
+    Returns the result of adding the piece (as addPiece_Map) if the piece would be (partially) outside the map, otherwise returns 0.
+    The problems are the ones of the first cell of the piece with one, in the order of the rows (and the center of the piece before all),
+    so all the backends give the same result; the backends only check the pieces that lie inside the map, each in its own way.
+*/
+static int checkBounds(Map* map, Piece* piece)
+{
+    if(!inside(map, piece->posX, piece->posY))
+        return 1;
+
+    for(int x = piece->posX - 2; x <= piece->posX + 2; x++)
+        for(int y = piece->posY - 2; y <= piece->posY + 2; y++)
+            if(getStatus_Piece(piece, x, y) == 1 && !inside(map, x, y)) {
+                // The cells of the piece before this one, which are inside the map, may already have a piece
+                for(int i = piece->posX - 2; i <= x; i++)
+                    for(int j = piece->posY - 2; j <= piece->posY + 2 && (i < x || j < y); j++)
+                        if(getStatus_Piece(piece, i, j) == 1 && getPieceStatus_Map(map, i, j) != 0)
+                            return 2;
+                return 1;
+            }
+    return 0;
+}
 
 int addPiece_Map(Map* map, Piece* piece)
 {
-    int resultAddingPiece = canAddPiece(map, piece);
-    // If the result of the function canAddPiece is 0, then the piece can be added and it's added
-    if(resultAddingPiece == 0)
-        attactchPiece(map, piece);
-    return resultAddingPiece;
+    int result = checkBounds(map, piece);
+    if(result != 0)
+        return result;
+    return map->backend->addPiece(map, piece);
 }
 
-int getPieceStatus_Map(Map* map, int x, int y)
+int registerAttack_Map(Map* map, int x, int y)
 {
-    // Case there's no piece, return 0
-    if(map->cells[x][y]->piece == NULL) return 0;
-    // Case there's a piece, return the status of the piece on position (x,y)
-    return getStatus_Piece(map->cells[x][y]->piece, x, y);
+    return map->backend->registerAttack(map, x, y);
 }
 
-int getShotStatus_Map(Map* map, int x, int y)
+void registerShot_Map(Map* map, int x, int y, byte b)
 {
-    return map->cells[x][y]->shot;
+    map->backend->registerShot(map, x, y, b);
 }
 
-int registerAttack_Map(Map* map, int x, int y)
+int getPieceStatus_Map(Map* map, int x, int y)
 {
-    /*
-        Attack outside the map.
-        This needs to be verified first, to not cause a segmentation fault
-        on the call made next to the function getPieceStatus,
-        which would try to acess invalid positions on the map.
-    */
-    if(x < 0 || x >= map->size || y < 0 || y >= map->size)
-        return -1;
-
-    switch(getPieceStatus_Map(map, x, y)) {
-        // Case there's no piece
-        case 0: return 0;
-
-        // Case there's a piece, not hitted
-        case 1: {
-            // Mark on the state of the piece that the position was hitted.
-            registerAttack_Piece(map->cells[x][y]->piece, x, y);
-
-            // Return accordingly to piece hitted
-            switch(getType_Piece(map->cells[x][y]->piece)) {
-                case 'I': return 1;
-                case 'P': return 2;
-                case 'T': return 3;
-                case 'X': return 4;
-                case 'Z': return 5;
-                default: prompt_IO(ERROR_IO, "map.c, registerAttack_Map(): invalid piece type");
-            }
-        }
-        // Case there's a piece, but already hitted
-        case 2: return 6;
-
-        // Case it's an invalid piece status: notify and abort execution
-        default: prompt_IO(ERROR_IO, "map.c, registerAttack_Map(): invalid piece status");
-    }
-
-    // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
-    return 0;
+    return map->backend->getPieceStatus(map, x, y);
 }
 
-void registerShot_Map(Map* map, int x, int y, byte b)
+int getShotStatus_Map(Map* map, int x, int y)
 {
-    map->cells[x][y]->shot = b;
+    return map->backend->getShotStatus(map, x, y);
 }
 
 char getPieceType_Map(Map* map, int x, int y)
 {
-    return getType_Piece(map->cells[x][y]->piece);
+    return map->backend->getPieceType(map, x, y);
 }
 
-void free_Map(Map* map)
+// Context of the visitor exportCell
+typedef struct Export
 {
-    for(int x = 0; x < map->size; x++) {
-        for(int y = 0; y < map->size; y++) {
-            if(map->cells[x][y]->piece != NULL) {
-                // The piece is only dealloced in the center position to avoid that we dealloc more than one time.
-                if(map->cells[x][y]->piece->posX == x && map->cells[x][y]->piece->posY == y)
-                    free_Piece(map->cells[x][y]->piece);
-            }
-            free_Cell(map->cells[x][y]);
-        }
-    }
-    free(map);
-}
-
-#else // QUADTREE
+    Map* map;
+    byte* rows;
+    bool pieces;
+} Export;
 
-/*
-    Function that see's if a piece can be added to the map.
-    If it returns 0, than the piece can be added.
-    If it returns 1, than (parts of) the piece would be outside the map
-    If it returns 2, than (parts of) the piece would intersect with previous pieces, that is, there is already a (at least one) piece (or parts of), where this piece lies.
-    Note: Nothing to the map happens, in all the cases.
-*/
-static int canAddPiece(Map* map, Piece* piece)
+// Visitor (see cell.h) that writes the byte of each cell stored on the rows of the context
+static bool exportCell(Cell* cell, int x, int y, void* context)
 {
-    for(int x = piece->posX - 2; x <= piece->posX + 2; x++) {
-        for(int y = piece->posY - 2; y <= piece->posY + 2; y++) {
-            // For the positions (x,y) that we need to attactch the piece, we need to see if:
-            if(getStatus_Piece(piece, x, y) == 1) {
-                // it's a valid position on the map
-                if(x < 0 || x >= map->size || y < 0 || y >= map->size)
-                    return 1;
-                // and there's a piece there already.
-                if(hasCell_QuadTree(map->qt, x, y))
-                    return 2;
-            }
-        }
+    Export* export = (Export*) context;
+    byte* b = &export->rows[x * export->map->size + y];
+
+    if(!export->pieces)
+        *b = getShot_Cell(cell);
+    else if(hasPiece_Cell(cell)) {
+        Piece* piece = getPiece_Cell(cell, export->map->pieces);
+        *b = getStatus_Piece(piece, x, y) == 2 ? 6 : getTypeIndex_Utils(getType_Piece(piece)) + 1;
     }
-    // At this point, we know that the piece can be attactched
-    return 0;
+    return true;
 }
 
-// Simple function to attactch the piece to the map.
-static void attactchPiece(Map* map, Piece* piece)
+void exportRows_Map(Map* map, byte* rows, bool pieces)
 {
-    for(int i = piece->posX - 2; i <= piece->posX + 2; i++) {
-        for(int j = piece->posY - 2; j <= piece->posY + 2; j++) {
-            if(getStatus_Piece(piece, i, j) == 1){
-                Cell* cell = new_Cell();
-                cell->piece = piece;
-                insert_QuadTree(map->qt, cell, i, j);
-            }
-        }  
+    if(map->backend->exportRows != NULL) {
+        map->backend->exportRows(map, rows, pieces);
+        return;
     }
+
+    // The cells not stored have no piece and no shot
+    memset(rows, 0, (size_t) map->size * map->size);
+    Export export = { map, rows, pieces };
+    map->backend->visitCells(map, exportCell, &export);
 }
 
-Map* new_Map(int size) 
+// Returns true if the operations on the handle must call the functions of the backend, with (x,y), because it doesn't store cells
+static bool byPosition(CellHandle* handle)
 {
-    Map* map = (Map*)malloc(sizeof(Map));
-    if(map == NULL)
-        prompt_IO(ERROR_IO, "map.c, new_Map(): malloc failed");
-    
-    map->size = size;
-    map->qt = new_QuadTree(size);
-   
-    return map;
+    return handle->map->backend->findCell == NULL;
 }
 
+CellHandle findCell_Map(Map* map, int x, int y)
+{
+    CellHandle handle = { map, x, y, NULL };
+    if(map->backend->findCell != NULL && inside(map, x, y))
+        handle.cell = map->backend->findCell(map, x, y);
+    return handle;
+}
 
-int addPiece_Map(Map* map, Piece* piece)
+CellHandle findOrInsertCell_Map(Map* map, int x, int y)
 {
-  int resultAddingPiece = canAddPiece(map, piece);
-    // If the result of the function canAddPiece is 0, then the piece can be added and it's added
-    if(resultAddingPiece == 0) 
-        attactchPiece(map, piece);
-    return resultAddingPiece;
-  return -1;
+    CellHandle handle = { map, x, y, NULL };
+    if(map->backend->insertCell != NULL && inside(map, x, y))
+        handle.cell = map->backend->insertCell(map, x, y);
+    return handle;
 }
 
-int registerAttack_Map(Map* map, int x, int y)
+int registerAttackCell_Map(CellHandle* handle)
 {
+    if(byPosition(handle))
+        return registerAttack_Map(handle->map, handle->x, handle->y);
+
     // Attack outside the map.
-    if(x < 0 || x >= map->size || y < 0 || y >= map->size)
+    if(!inside(handle->map, handle->x, handle->y))
         return -1;
-    
-    // Search for the cell, on position (x,y)
-    Cell* cell_found = NULL;
-    search_QuadTree(map->qt, &cell_found, x, y);
-    
+
     // Case there's no piece
-    if(cell_found == NULL || cell_found->piece == NULL) return 0; 
+    if(handle->cell == NULL || !hasPiece_Cell(handle->cell))
+        return 0;
 
     // Case there's a piece
-    int val = getStatus_Piece(cell_found->piece, x, y);
-    switch(val) {
+    Piece* piece = getPiece_Cell(handle->cell, handle->map->pieces);
+    switch(getStatus_Piece(piece, handle->x, handle->y)) {
         // Case there's a piece, hitted
         case 1: {
             // Mark on the state of the piece that the position was hitted.
-            registerAttack_Piece(cell_found->piece, x, y);
+            registerAttack_Piece(piece, handle->x, handle->y);
 
             // Return accordingly to piece hitted
-            switch(getType_Piece(cell_found->piece)) {
-                case 'I': return 1;
-                case 'P': return 2;
-                case 'T': return 3;
-                case 'X': return 4;
-                case 'Z': return 5;
-                default: prompt_IO(ERROR_IO, "map.c, registerAttack_Map(): invalid piece type");
-            }
+            return getTypeIndex_Utils(getType_Piece(piece)) + 1;
         }
         // Case there's a piece, but already hitted
         case 2: return 6;
         // Case it's an invalid piece status: notify and abort execution
-        default: prompt_IO(ERROR_IO, "map.c, registerAttack_Map(): invalid piece status");
+        default: prompt_IO(ERROR_IO, "map.c, registerAttackCell_Map(): invalid piece status");
     }
 
     // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
     return 0;
 }
 
-void registerShot_Map(Map* map, int x, int y, byte b)
+void registerShotCell_Map(CellHandle* handle, byte b)
 {
-  // Search for the cell on position (x,y).
-  Cell* cell_found = NULL;
-  search_QuadTree(map->qt, &cell_found, x, y);
-  
-  // If it's NULL then doesn't exist a node on the tree with the point (x,y), we must add one.
-  if(cell_found == NULL) {
-      Cell* cell = new_Cell();
-      cell->shot = b;
-      insert_QuadTree(map->qt, cell, x, y);
-  }
-  // Case it exists. 
-  else
-    cell_found->shot = b;
+    if(byPosition(handle)) {
+        registerShot_Map(handle->map, handle->x, handle->y, b);
+        return;
+    }
+
+    if(handle->cell == NULL)
+        *handle = findOrInsertCell_Map(handle->map, handle->x, handle->y);
+    if(handle->cell != NULL)
+        setShot_Cell(handle->cell, b);
 }
 
-int getPieceStatus_Map(Map* map, int x, int y)
+int getPieceStatusCell_Map(CellHandle* handle)
 {
-  // Search for the cell on position (x,y).
-  Cell* cell_found = NULL;
-  search_QuadTree(map->qt, &cell_found, x, y);
-  
-  // Case no cell or piece.
-  if(cell_found == NULL || cell_found->piece == NULL) 
-    return 0;
-  // Case there's a piece.
-  else
-    return getStatus_Piece(cell_found->piece, x, y);
+    if(byPosition(handle))
+        return getPieceStatus_Map(handle->map, handle->x, handle->y);
+
+    if(handle->cell == NULL || !hasPiece_Cell(handle->cell))
+        return 0;
+    return getStatus_Piece(getPiece_Cell(handle->cell, handle->map->pieces), handle->x, handle->y);
 }
 
-int getShotStatus_Map(Map* map, int x, int y)
+int getShotStatusCell_Map(CellHandle* handle)
 {
-  // Search for the cell on position (x,y).
-  Cell* cell_found = NULL;
-  search_QuadTree(map->qt, &cell_found, x, y);
-  
-  // Case there's no cell.
-  if(cell_found == NULL)
-    return 0;
-  // Case there's a cell.
-  else
-    return cell_found->shot;
+    if(byPosition(handle))
+        return getShotStatus_Map(handle->map, handle->x, handle->y);
+
+    return handle->cell == NULL ? 0 : getShot_Cell(handle->cell);
 }
 
-char getPieceType_Map(Map* map, int x, int y)
+char getPieceTypeCell_Map(CellHandle* handle)
 {
-    // Search for the cell on position (x,y).
-    Cell* cell;
-    search_QuadTree(map->qt, &cell, x, y);
+    if(byPosition(handle))
+        return getPieceType_Map(handle->map, handle->x, handle->y);
 
-    // As stated in the header file, this function doesn't validate if the piece exists, 
-    // since everytime we use this function, we know the piece already exist.
-    return getType_Piece(cell->piece);
+    return getType_Piece(getPiece_Cell(handle->cell, handle->map->pieces));
 }
 
 void free_Map(Map* map)
 {
-  free_QuadTree(map->qt);
-  free(map);
+    map->backend->freeMap(map);
 }
 
-#endif
+bool findOverlap_Map(Cell* cell, int x, int y, void* context)
+{
+    Overlap* overlap = (Overlap*) context;
+    if(hasPiece_Cell(cell) && getStatus_Piece(overlap->piece, x, y) == 1) {
+        overlap->found = true;
+        return false;
+    }
+    return true;
+}
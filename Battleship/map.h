@@ -12,36 +12,38 @@
 
 #include "cell.h"
 
-#ifdef MATRIX
-
-//  Definition of the Map
+/*
+    Definition of the Map.
+    The cells are kept by a backend (see mapbackend.h), chosen, at runtime, when the map is allocated.
+    Each backend extends this struct with its own fields.
+*/
 typedef struct Map
 {
     // Size of the map
     int size;
 
-    // Cells of the map
-    Cell*** cells;
-} Map;
-
-#else //QUADTREE
-
-#include "quadtree.h"
-
-typedef struct Map
-{
-    // Size of the map
-    int size;
+    // Array of the pieces that can be added to the map (it's not owned by the map). The cells refer to the pieces by their position in it.
+    Piece* pieces;
 
-    // Cells of the map
-    QuadTree* qt;
+    // Backend of the map
+    const struct MapBackend* backend;
 } Map;
 
-#endif
+/*
+    Chooses, by its name, the backend of the maps allocated from now on:
+    "quadtree" (the default), "matrix", "bitboard", "linear" or "adaptive".
+    Returns true if the backend exists, otherwise returns false and nothing changes.
+*/
+bool setBackend_Map(const char* name);
 
+// Returns the name of the backend of the maps allocated from now on
+const char* getBackend_Map();
 
-//  Allocs a new square map of width 'size'
-Map* new_Map(int size);
+/*
+    Allocs a new square map of width 'size'.
+    The pieces added to the map must be in the array 'pieces', which must live longer than the map.
+*/
+Map* new_Map(int size, Piece* pieces);
 
 /*
     Tries to add a piece to the map and returns an int, signaling the result of adding the piece.
@@ -87,7 +89,52 @@ int getShotStatus_Map(Map* map, int x, int y);
 // If doesn't get verified, because in the program, when we call this function we had always verify if the piece existed, before.
 char getPieceType_Map(Map* map, int x, int y);
 
-// Frees the map and all resources in it
+/*
+    Fills 'rows' with the whole map, one byte per cell, the cell (x,y) on rows[x * size + y], in one pass over the structure of the backend (no search per cell).
+    If 'pieces' is true, the byte is 0 if there's no piece, 1 to 5 if there's a piece of type I, P, T, X or Z not hitted (as in registerAttack_Map) and 6 if it's hitted.
+    Otherwise, the byte is the shot status of the cell (as in getShotStatus_Map).
+*/
+void exportRows_Map(Map* map, byte* rows, bool pieces);
+
+/*
+    Handle of a cell of the map, resolved once, so several operations on the same position need only one lookup.
+    A turn, for example, attacks a cell of the map of one player and registers the shot on the same cell of the map of the other one.
+    The handle is valid till a piece is added to the map or another cell is inserted on it
+    (the backend "linear" moves its cells when one is inserted, and "adaptive" moves them all when it changes to a matrix).
+*/
+typedef struct CellHandle
+{
+    // Map and position (x,y) of the cell
+    Map* map;
+    int x, y;
+
+    // The cell, if it's stored by the map, otherwise NULL.
+    // For the backends that don't store cells ("bitboard") it's always NULL, and the operations call the functions above, with (x,y).
+    Cell* cell;
+} CellHandle;
+
+// Returns the handle of the cell (x,y), only searching for it (nothing is inserted on the map)
+CellHandle findCell_Map(Map* map, int x, int y);
+
+// Returns the handle of the cell (x,y), inserting the cell on the map if it isn't stored yet (on the quadtree, on the same descent as the search)
+CellHandle findOrInsertCell_Map(Map* map, int x, int y);
+
+// The same as registerAttack_Map, on the cell of the handle
+int registerAttackCell_Map(CellHandle* handle);
+
+// The same as registerShot_Map, on the cell of the handle (if the cell isn't stored yet, it's inserted, and the handle updated)
+void registerShotCell_Map(CellHandle* handle, byte b);
+
+// The same as getPieceStatus_Map, on the cell of the handle
+int getPieceStatusCell_Map(CellHandle* handle);
+
+// The same as getShotStatus_Map, on the cell of the handle
+int getShotStatusCell_Map(CellHandle* handle);
+
+// The same as getPieceType_Map, on the cell of the handle (and just as unsafe)
+char getPieceTypeCell_Map(CellHandle* handle);
+
+// Frees the map and all resources in it, except the pieces (which are in the array given to new_Map)
 void free_Map(Map*);
 
 #endif
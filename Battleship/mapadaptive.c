@@ -0,0 +1,151 @@
+#include "mapbackend.h"
+
+#include "io.h"
+#include <stdlib.h>
+
+/*
+    Percentage of the cells of the map that must be stored, for the map to move to the dense backend.
+    A quadtree with this many cells already spends more time descending, and more memory on regions, than a matrix.
+*/
+#define DENSITY_THRESHOLD 25
+
+/*
+    Map that starts with its cells on the sparse backend (quadtree) and,
+    once they pass DENSITY_THRESHOLD percent of the map, moves them to the dense backend (matrix).
+    The move happens once, inside addPiece or registerShot, so it's transparent to whoever uses the map.
+*/
+typedef struct AdaptiveMap
+{
+    Map base;
+
+    // Map, of the backend in use, where the cells are
+    Map* inner;
+} AdaptiveMap;
+
+// Allocs a map of the given backend
+static Map* newInner(const MapBackend* backend, int size, Piece* pieces)
+{
+    Map* map = backend->newMap(size, pieces);
+    map->backend = backend;
+    return map;
+}
+
+// Visitor that copies a cell of the sparse map to the dense map (the context). Both maps share the array of pieces, so the number of the piece of the cell stays valid.
+static bool copyCell(Cell* cell, int x, int y, void* context)
+{
+    Map* dense = (Map*) context;
+    *dense->backend->insertCell(dense, x, y) = *cell;
+    return true;
+}
+
+// Moves the cells to the dense backend, if the sparse one already has too many
+static void adapt(AdaptiveMap* map)
+{
+    Map* sparse = map->inner;
+    if(sparse->backend != &quadtreeBackend || sparse->backend->countCells(sparse) * 100 < DENSITY_THRESHOLD * sparse->size * sparse->size)
+        return;
+
+    Map* dense = newInner(&matrixBackend, sparse->size, sparse->pieces);
+    sparse->backend->visitCells(sparse, copyCell, dense);
+
+    // The pieces (and their state) are in the array of pieces, that none of the maps frees.
+    free_Map(sparse);
+    map->inner = dense;
+}
+
+static Map* new_AdaptiveMap(int size, Piece* pieces)
+{
+    AdaptiveMap* map = (AdaptiveMap*) malloc(sizeof(AdaptiveMap));
+    if(map == NULL)
+        prompt_IO(ERROR_IO, "mapadaptive.c, new_AdaptiveMap(): malloc failed");
+
+    map->base.size = size;
+    map->base.pieces = pieces;
+    map->inner = newInner(&quadtreeBackend, size, pieces);
+
+    return &map->base;
+}
+
+static int addPiece_AdaptiveMap(Map* base, Piece* piece)
+{
+    AdaptiveMap* map = (AdaptiveMap*) base;
+    int resultAddingPiece = addPiece_Map(map->inner, piece);
+    if(resultAddingPiece == 0)
+        adapt(map);
+    return resultAddingPiece;
+}
+
+static int registerAttack_AdaptiveMap(Map* base, int x, int y)
+{
+    return registerAttack_Map(((AdaptiveMap*) base)->inner, x, y);
+}
+
+static void registerShot_AdaptiveMap(Map* base, int x, int y, byte b)
+{
+    AdaptiveMap* map = (AdaptiveMap*) base;
+    registerShot_Map(map->inner, x, y, b);
+    adapt(map);
+}
+
+static int getPieceStatus_AdaptiveMap(Map* base, int x, int y)
+{
+    return getPieceStatus_Map(((AdaptiveMap*) base)->inner, x, y);
+}
+
+static int getShotStatus_AdaptiveMap(Map* base, int x, int y)
+{
+    return getShotStatus_Map(((AdaptiveMap*) base)->inner, x, y);
+}
+
+static char getPieceType_AdaptiveMap(Map* base, int x, int y)
+{
+    return getPieceType_Map(((AdaptiveMap*) base)->inner, x, y);
+}
+
+static void free_AdaptiveMap(Map* base)
+{
+    free_Map(((AdaptiveMap*) base)->inner);
+    free(base);
+}
+
+static int countCells_AdaptiveMap(Map* base)
+{
+    Map* inner = ((AdaptiveMap*) base)->inner;
+    return inner->backend->countCells(inner);
+}
+
+static void visitCells_AdaptiveMap(Map* base, CellVisitor visitor, void* context)
+{
+    Map* inner = ((AdaptiveMap*) base)->inner;
+    inner->backend->visitCells(inner, visitor, context);
+}
+
+static Cell* findCell_AdaptiveMap(Map* base, int x, int y)
+{
+    Map* inner = ((AdaptiveMap*) base)->inner;
+    return inner->backend->findCell(inner, x, y);
+}
+
+// The map adapts before the cell is inserted, not after (as registerShot does), so the cell returned isn't moved to the matrix right away
+static Cell* insertCell_AdaptiveMap(Map* base, int x, int y)
+{
+    AdaptiveMap* map = (AdaptiveMap*) base;
+    adapt(map);
+    return map->inner->backend->insertCell(map->inner, x, y);
+}
+
+const MapBackend adaptiveBackend = {
+    .name = "adaptive",
+    .newMap = new_AdaptiveMap,
+    .addPiece = addPiece_AdaptiveMap,
+    .registerAttack = registerAttack_AdaptiveMap,
+    .registerShot = registerShot_AdaptiveMap,
+    .getPieceStatus = getPieceStatus_AdaptiveMap,
+    .getShotStatus = getShotStatus_AdaptiveMap,
+    .getPieceType = getPieceType_AdaptiveMap,
+    .freeMap = free_AdaptiveMap,
+    .countCells = countCells_AdaptiveMap,
+    .visitCells = visitCells_AdaptiveMap,
+    .findCell = findCell_AdaptiveMap,
+    .insertCell = insertCell_AdaptiveMap
+};
@@ -0,0 +1,64 @@
+/*
+  mapbackend.h
+  Interface of the backends of the map.
+
+  A backend keeps the cells of the map in its own structure and implements, for it, all the functions of map.h.
+  The structure of each backend starts with a Map (the field 'base'), so a pointer to it is also a pointer to a Map.
+  The functions of map.h only call the functions of the backend of the map.
+*/
+
+#ifndef MAPBACKEND_H
+#define MAPBACKEND_H
+
+#include "map.h"
+
+// Definition of a backend: its name and its functions, with the same meaning of the functions of map.h
+typedef struct MapBackend
+{
+    // Name used to choose the backend
+    const char* name;
+
+    // Allocs the map of the backend, setting its size and its array of pieces. The field backend is set by new_Map.
+    Map* (*newMap)(int size, Piece* pieces);
+    // Only called with the pieces inside the map (addPiece_Map checks the bounds before, so all the backends give the same result)
+    int (*addPiece)(Map* map, Piece* piece);
+    int (*registerAttack)(Map* map, int x, int y);
+    void (*registerShot)(Map* map, int x, int y, byte b);
+    int (*getPieceStatus)(Map* map, int x, int y);
+    int (*getShotStatus)(Map* map, int x, int y);
+    char (*getPieceType)(Map* map, int x, int y);
+    void (*freeMap)(Map* map);
+
+    // Returns the number of cells stored by the backend (for the dense backends, all the cells of the map)
+    int (*countCells)(Map* map);
+    // Calls the visitor for each cell stored by the backend (see cell.h). NULL for the backends that don't store cells.
+    void (*visitCells)(Map* map, CellVisitor visitor, void* context);
+    // Fills the rows of the map (as exportRows_Map). NULL for the backends where it's done with visitCells.
+    void (*exportRows)(Map* map, byte* rows, bool pieces);
+    // Returns the cell (x,y), or NULL if it isn't stored. NULL for the backends that don't store cells.
+    Cell* (*findCell)(Map* map, int x, int y);
+    // Returns the cell (x,y), inserting it if it isn't stored yet. NULL for the backends that don't store cells.
+    Cell* (*insertCell)(Map* map, int x, int y);
+} MapBackend;
+
+// The backends available
+extern const MapBackend matrixBackend;
+extern const MapBackend quadtreeBackend;
+extern const MapBackend bitboardBackend;
+extern const MapBackend linearBackend;
+extern const MapBackend adaptiveBackend;
+
+// Context of the visitor findOverlap_Map
+typedef struct Overlap
+{
+    Piece* piece;
+    bool found;
+} Overlap;
+
+/*
+    Visitor (see cell.h) that stops on the first cell with a piece, where the piece of the context also lies, setting the field found of the context to true.
+    Used to see if a piece can be added on the maps based on quadtrees.
+*/
+bool findOverlap_Map(Cell* cell, int x, int y, void* context);
+
+#endif
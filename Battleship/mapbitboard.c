@@ -0,0 +1,325 @@
+#include "mapbackend.h"
+
+#include "utils.h"
+#include "io.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+// Number of planes of the number of the piece of the cells (the 13 bits of the cells, see cell.h)
+#define NUMBER_PLANES 13
+
+// Number of planes of the map: the occupancy, the hits, the type, the shots and the number of the piece
+#define PLANES (8 + NUMBER_PLANES)
+
+/*
+    Map with the cells in bit planes.
+    Each state of the cells is kept in a bit plane: 'size' rows of 'words' 64-bit words,
+    with the bit (y % 64) of the word (y / 64), of the row x, corresponding to the cell (x,y).
+ */
+typedef struct BitBoardMap
+{
+    Map base;
+
+    // Number of 64-bit words of each row of a plane
+    int words;
+
+    // Cells with a piece
+    uint64_t* occupancy;
+    // Cells with a piece, already hitted
+    uint64_t* hit;
+    // Number (1 to 5) of the type of the piece of the cell (I, P, T, X and Z, respectively), in binary, one plane per bit
+    uint64_t* type[3];
+    // Field 'shot' of the cell (0 to 6), in binary, one plane per bit
+    uint64_t* shot[3];
+    // Number of the piece of the cell (its position in the array of pieces plus one, as on the cells, see cell.h), in binary, one plane per bit
+    uint64_t* number[NUMBER_PLANES];
+} BitBoardMap;
+
+// Returns the row x of a plane of the map
+static uint64_t* row(BitBoardMap* map, uint64_t* plane, int x)
+{
+    return plane + x * map->words;
+}
+
+// Returns the bit of the cell (x,y) on a plane
+static int getBit(BitBoardMap* map, uint64_t* plane, int x, int y)
+{
+    return (row(map, plane, x)[y >> 6] >> (y & 63)) & 1;
+}
+
+// Sets the bit of the cell (x,y) on a plane to b
+static void setBit(BitBoardMap* map, uint64_t* plane, int x, int y, int b)
+{
+    uint64_t* word = &row(map, plane, x)[y >> 6];
+    if(b) *word |= (uint64_t) 1 << (y & 63);
+    else *word &= ~((uint64_t) 1 << (y & 63));
+}
+
+/*
+    Returns true if the row 'r' of a plane has some bit set in common with the mask 'mask',
+    the bit 0 of the mask corresponding to the column 'y'.
+    The mask only has 5 bits, so it lies, at most, in two consecutive words.
+*/
+static bool testRow(BitBoardMap* map, uint64_t* r, int y, uint64_t mask)
+{
+    int w = y >> 6, offset = y & 63;
+    if(r[w] & (mask << offset))
+        return true;
+    return offset != 0 && w + 1 < map->words && (r[w + 1] & (mask >> (64 - offset)));
+}
+
+// Sets, on the row 'r' of a plane, the bits of the mask 'mask', the bit 0 of the mask corresponding to the column 'y'.
+static void setRow(BitBoardMap* map, uint64_t* r, int y, uint64_t mask)
+{
+    int w = y >> 6, offset = y & 63;
+    r[w] |= mask << offset;
+    if(offset != 0 && w + 1 < map->words)
+        r[w + 1] |= mask >> (64 - offset);
+}
+
+/*
+    Stores in 'masks' the rows of the piece, where the bit j of the mask i corresponds to the position (posX - 2 + i, posY - 2 + j).
+    The rows are taken directly from the mask of the format of the piece, where the row i is the group of 5 bits starting on the bit 5 * i.
+    If the piece would be (partially) outside the map, returns false, otherwise, returns true.
+    To not deal with negative shifts, the masks are shifted, so they start on the column *p_first_column (instead of posY - 2), which is never negative.
+*/
+static bool getRows(BitBoardMap* map, Piece* piece, uint64_t masks[5], int* p_first_column)
+{
+    int first_column = piece->posY - 2;
+    // Number of columns of the map, starting on the first column of the piece
+    int columns_left = map->base.size - first_column;
+
+    for(int i = 0; i < 5; i++) {
+        masks[i] = (piece->shape >> (5 * i)) & 31;
+        if(masks[i] == 0) continue;
+
+        // Part of the piece is outside the map: on a row outside of the map,
+        int x = piece->posX - 2 + i;
+        if(x < 0 || x >= map->base.size)
+            return false;
+        // on a negative column
+        if(first_column < 0 && (first_column <= -5 || (masks[i] & ((1 << -first_column) - 1))))
+            return false;
+        // or on a column after the last one.
+        if(columns_left < 5 && (columns_left <= 0 || (masks[i] >> columns_left)))
+            return false;
+    }
+
+    // Since every position of the piece is inside the map, the positions on negative columns are all empty
+    if(first_column < 0) {
+        for(int i = 0; i < 5; i++)
+            masks[i] >>= -first_column;
+        first_column = 0;
+    }
+    *p_first_column = first_column;
+    return true;
+}
+
+/*
+    Function that see's if a piece can be added to the map.
+    If it returns 0, than the piece can be added.
+    If it returns 1, than (parts of) the piece would be outside the map
+    If it returns 2, than (parts of) the piece would intersect with previous pieces, that is, there is already a (at least one) piece (or parts of), where this piece lies.
+    Note: Nothing to the map happens, in all the cases.
+    The intersection is checked row by row, testing the 5 columns of the piece at once.
+*/
+static int canAddPiece(BitBoardMap* map, Piece* piece, uint64_t masks[5], int* p_first_column)
+{
+    if(!getRows(map, piece, masks, p_first_column))
+        return 1;
+
+    for(int i = 0; i < 5; i++)
+        if(masks[i] != 0 && testRow(map, row(map, map->occupancy, piece->posX - 2 + i), *p_first_column, masks[i]))
+            return 2;
+
+    // At this point, we know that the piece can be attactched
+    return 0;
+}
+
+// Simple function to attactch the piece to the map, given the rows computed by canAddPiece.
+static void attactchPiece(BitBoardMap* map, Piece* piece, uint64_t masks[5], int first_column)
+{
+    int type = getTypeIndex_Utils(getType_Piece(piece)) + 1;
+    int number = (int) (piece - map->base.pieces) + 1;
+    // Case the number of the piece doesn't fit in its planes: notify and abort execution
+    if(number < 1 || number > MAX_PIECES_CELL)
+        prompt_IO(ERROR_IO, "mapbitboard.c, attactchPiece(): invalid piece");
+
+    for(int i = 0; i < 5; i++) {
+        if(masks[i] == 0) continue;
+        int x = piece->posX - 2 + i;
+        setRow(map, row(map, map->occupancy, x), first_column, masks[i]);
+        for(int b = 0; b < 3; b++)
+            if(type & (1 << b))
+                setRow(map, row(map, map->type[b], x), first_column, masks[i]);
+        for(int b = 0; b < NUMBER_PLANES; b++)
+            if(number & (1 << b))
+                setRow(map, row(map, map->number[b], x), first_column, masks[i]);
+    }
+}
+
+static Map* new_BitBoardMap(int size, Piece* pieces)
+{
+    BitBoardMap* map = (BitBoardMap*) malloc(sizeof(BitBoardMap));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(map == NULL)
+        prompt_IO(ERROR_IO, "mapbitboard.c, new_BitBoardMap(): first malloc failed");
+
+    map->base.size = size;
+    map->base.pieces = pieces;
+    map->words = (size + 63) / 64;
+
+    // All the planes are in one block, cleared
+    int plane_size = size * map->words;
+    uint64_t* planes = (uint64_t*) calloc((size_t) PLANES * plane_size, sizeof(uint64_t));
+    // Case calloc failed, print that calloc failed and abort execution
+    if(planes == NULL)
+        prompt_IO(ERROR_IO, "mapbitboard.c, new_BitBoardMap(): calloc failed");
+
+    map->occupancy = planes;
+    map->hit = planes + plane_size;
+    for(int b = 0; b < 3; b++) {
+        map->type[b] = planes + (2 + b) * plane_size;
+        map->shot[b] = planes + (5 + b) * plane_size;
+    }
+    for(int b = 0; b < NUMBER_PLANES; b++)
+        map->number[b] = planes + (size_t) (8 + b) * plane_size;
+
+    return &map->base;
+}
+
+static int addPiece_BitBoardMap(Map* base, Piece* piece)
+{
+    BitBoardMap* map = (BitBoardMap*) base;
+    uint64_t masks[5];
+    int first_column;
+    int resultAddingPiece = canAddPiece(map, piece, masks, &first_column);
+    // If the result of the function canAddPiece is 0, then the piece can be added and it's added
+    if(resultAddingPiece == 0)
+        attactchPiece(map, piece, masks, first_column);
+    return resultAddingPiece;
+}
+
+// Returns the piece of the cell (x,y), which must have one, from the planes of its number
+static Piece* getPiece(BitBoardMap* map, int x, int y)
+{
+    int number = 0;
+    for(int b = 0; b < NUMBER_PLANES; b++)
+        number |= getBit(map, map->number[b], x, y) << b;
+    return &map->base.pieces[number - 1];
+}
+
+static int getPieceStatus_BitBoardMap(Map* base, int x, int y)
+{
+    BitBoardMap* map = (BitBoardMap*) base;
+    // Case there's no piece, return 0
+    if(!getBit(map, map->occupancy, x, y)) return 0;
+    // Case there's a piece, return 2 if it's hitted and 1 otherwise
+    return getBit(map, map->hit, x, y) ? 2 : 1;
+}
+
+static int getShotStatus_BitBoardMap(Map* base, int x, int y)
+{
+    BitBoardMap* map = (BitBoardMap*) base;
+    return getBit(map, map->shot[0], x, y) | getBit(map, map->shot[1], x, y) << 1 | getBit(map, map->shot[2], x, y) << 2;
+}
+
+static int registerAttack_BitBoardMap(Map* base, int x, int y)
+{
+    BitBoardMap* map = (BitBoardMap*) base;
+    // Attack outside the map.
+    if(x < 0 || x >= map->base.size || y < 0 || y >= map->base.size)
+        return -1;
+
+    switch(getPieceStatus_BitBoardMap(base, x, y)) {
+        // Case there's no piece
+        case 0: return 0;
+
+        // Case there's a piece, not hitted
+        case 1: {
+            // Mark that the position was hitted, on the map and on the state of the piece.
+            setBit(map, map->hit, x, y, 1);
+            registerAttack_Piece(getPiece(map, x, y), x, y);
+
+            // Return accordingly to piece hitted, that is, the number of its type
+            return getBit(map, map->type[0], x, y) | getBit(map, map->type[1], x, y) << 1 | getBit(map, map->type[2], x, y) << 2;
+        }
+        // Case there's a piece, but already hitted
+        case 2: return 6;
+
+        // Case it's an invalid piece status: notify and abort execution
+        default: prompt_IO(ERROR_IO, "mapbitboard.c, registerAttack_BitBoardMap(): invalid piece status");
+    }
+
+    // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
+    return 0;
+}
+
+static void registerShot_BitBoardMap(Map* base, int x, int y, byte b)
+{
+    BitBoardMap* map = (BitBoardMap*) base;
+    for(int i = 0; i < 3; i++)
+        setBit(map, map->shot[i], x, y, (b >> i) & 1);
+}
+
+static char getPieceType_BitBoardMap(Map* base, int x, int y)
+{
+    BitBoardMap* map = (BitBoardMap*) base;
+    int type = getBit(map, map->type[0], x, y) | getBit(map, map->type[1], x, y) << 1 | getBit(map, map->type[2], x, y) << 2;
+    return getType_Utils(type - 1);
+}
+
+static void exportRows_BitBoardMap(Map* base, byte* rows, bool pieces)
+{
+    BitBoardMap* map = (BitBoardMap*) base;
+    int size = map->base.size;
+
+    // Each word of the planes is read once, and gives the bits of its 64 cells
+    for(int x = 0; x < size; x++) {
+        byte* out = rows + x * size;
+        for(int w = 0; w < map->words; w++) {
+            uint64_t occupancy = row(map, map->occupancy, x)[w], hit = row(map, map->hit, x)[w];
+            uint64_t** planes = pieces ? map->type : map->shot;
+            uint64_t bit0 = row(map, planes[0], x)[w], bit1 = row(map, planes[1], x)[w], bit2 = row(map, planes[2], x)[w];
+
+            for(int y = 64 * w, i = 0; y < size && i < 64; y++, i++) {
+                int value = ((bit0 >> i) & 1) | ((bit1 >> i) & 1) << 1 | ((bit2 >> i) & 1) << 2;
+                // On the pieces, the value is the number of the type, or 6 if the piece is hitted, or 0 if there's no piece
+                if(pieces)
+                    value = !((occupancy >> i) & 1) ? 0 : ((hit >> i) & 1) ? 6 : value;
+                out[y] = value;
+            }
+        }
+    }
+}
+
+static void free_BitBoardMap(Map* base)
+{
+    BitBoardMap* map = (BitBoardMap*) base;
+    // All the planes are in the block starting on the occupancy plane
+    free(map->occupancy);
+    free(map);
+}
+
+static int countCells_BitBoardMap(Map* base)
+{
+    return base->size * base->size;
+}
+
+const MapBackend bitboardBackend = {
+    .name = "bitboard",
+    .newMap = new_BitBoardMap,
+    .addPiece = addPiece_BitBoardMap,
+    .registerAttack = registerAttack_BitBoardMap,
+    .registerShot = registerShot_BitBoardMap,
+    .getPieceStatus = getPieceStatus_BitBoardMap,
+    .getShotStatus = getShotStatus_BitBoardMap,
+    .getPieceType = getPieceType_BitBoardMap,
+    .freeMap = free_BitBoardMap,
+    .countCells = countCells_BitBoardMap,
+    // The bitboards don't store cells
+    .visitCells = NULL,
+    .exportRows = exportRows_BitBoardMap,
+    .findCell = NULL,
+    .insertCell = NULL
+};
@@ -0,0 +1,196 @@
+#include "mapbackend.h"
+
+#include "linquadtree.h"
+#include "io.h"
+#include <stdlib.h>
+
+// Map with the cells in a linear quadtree
+typedef struct LinearMap
+{
+    Map base;
+
+    // Cells of the map
+    LinearQuadTree* lqt;
+} LinearMap;
+
+/*
+    Function that see's if a piece can be added to the map.
+    If it returns 0, than the piece can be added.
+    If it returns 1, than (parts of) the piece would be outside the map
+    If it returns 2, than (parts of) the piece would intersect with previous pieces, that is, there is already a (at least one) piece (or parts of), where this piece lies.
+    Note: Nothing to the map happens, in all the cases.
+    The intersection is checked with one scan of the cells in the square of the piece.
+*/
+static int canAddPiece(LinearMap* map, Piece* piece)
+{
+    for(int x = piece->posX - 2; x <= piece->posX + 2; x++)
+        for(int y = piece->posY - 2; y <= piece->posY + 2; y++)
+            // For the positions (x,y) that we need to attactch the piece, we need to see if it's a valid position on the map
+            if(getStatus_Piece(piece, x, y) == 1 && (x < 0 || x >= map->base.size || y < 0 || y >= map->base.size))
+                return 1;
+
+    // and if there's a piece there already.
+    Overlap overlap = { piece, false };
+    visit_LinearQuadTree(map->lqt, piece->posX - 2, piece->posY - 2, piece->posX + 2, piece->posY + 2, findOverlap_Map, &overlap);
+    if(overlap.found)
+        return 2;
+
+    // At this point, we know that the piece can be attactched
+    return 0;
+}
+
+// Simple function to attactch the piece to the map.
+static void attactchPiece(LinearMap* map, Piece* piece)
+{
+    for(int i = piece->posX - 2; i <= piece->posX + 2; i++)
+        for(int j = piece->posY - 2; j <= piece->posY + 2; j++)
+            if(getStatus_Piece(piece, i, j) == 1)
+                setPiece_Cell(insert_LinearQuadTree(map->lqt, i, j), map->base.pieces, piece);
+}
+
+static Map* new_LinearMap(int size, Piece* pieces)
+{
+    LinearMap* map = (LinearMap*) malloc(sizeof(LinearMap));
+    if(map == NULL)
+        prompt_IO(ERROR_IO, "maplinear.c, new_LinearMap(): malloc failed");
+
+    map->base.size = size;
+    map->base.pieces = pieces;
+    map->lqt = new_LinearQuadTree();
+
+    return &map->base;
+}
+
+static int addPiece_LinearMap(Map* base, Piece* piece)
+{
+    LinearMap* map = (LinearMap*) base;
+    int resultAddingPiece = canAddPiece(map, piece);
+    // If the result of the function canAddPiece is 0, then the piece can be added and it's added
+    if(resultAddingPiece == 0)
+        attactchPiece(map, piece);
+    return resultAddingPiece;
+}
+
+static int registerAttack_LinearMap(Map* base, int x, int y)
+{
+    LinearMap* map = (LinearMap*) base;
+    // Attack outside the map.
+    if(x < 0 || x >= map->base.size || y < 0 || y >= map->base.size)
+        return -1;
+
+    // Search for the cell, on position (x,y)
+    Cell* cell_found = search_LinearQuadTree(map->lqt, x, y);
+
+    // Case there's no piece
+    if(cell_found == NULL || !hasPiece_Cell(cell_found)) return 0;
+
+    // Case there's a piece
+    Piece* piece = getPiece_Cell(cell_found, map->base.pieces);
+    switch(getStatus_Piece(piece, x, y)) {
+        // Case there's a piece, not hitted
+        case 1: {
+            // Mark on the state of the piece that the position was hitted.
+            registerAttack_Piece(piece, x, y);
+
+            // Return accordingly to piece hitted
+            switch(getType_Piece(piece)) {
+                case 'I': return 1;
+                case 'P': return 2;
+                case 'T': return 3;
+                case 'X': return 4;
+                case 'Z': return 5;
+                default: prompt_IO(ERROR_IO, "maplinear.c, registerAttack_LinearMap(): invalid piece type");
+            }
+        }
+        // Case there's a piece, but already hitted
+        case 2: return 6;
+        // Case it's an invalid piece status: notify and abort execution
+        default: prompt_IO(ERROR_IO, "maplinear.c, registerAttack_LinearMap(): invalid piece status");
+    }
+
+    // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
+    return 0;
+}
+
+static void registerShot_LinearMap(Map* base, int x, int y, byte b)
+{
+    LinearMap* map = (LinearMap*) base;
+    // A missed shot creates the cell, if it doesn't exist yet
+    setShot_Cell(insert_LinearQuadTree(map->lqt, x, y), b);
+}
+
+static int getPieceStatus_LinearMap(Map* base, int x, int y)
+{
+    LinearMap* map = (LinearMap*) base;
+    Cell* cell_found = search_LinearQuadTree(map->lqt, x, y);
+
+    // Case no cell or piece.
+    if(cell_found == NULL || !hasPiece_Cell(cell_found))
+        return 0;
+    // Case there's a piece.
+    return getStatus_Piece(getPiece_Cell(cell_found, map->base.pieces), x, y);
+}
+
+static int getShotStatus_LinearMap(Map* base, int x, int y)
+{
+    LinearMap* map = (LinearMap*) base;
+    Cell* cell_found = search_LinearQuadTree(map->lqt, x, y);
+
+    // Case there's no cell.
+    if(cell_found == NULL)
+        return 0;
+    // Case there's a cell.
+    return getShot_Cell(cell_found);
+}
+
+static char getPieceType_LinearMap(Map* base, int x, int y)
+{
+    LinearMap* map = (LinearMap*) base;
+    // As stated in the header file, this function doesn't validate if the piece exists,
+    // since everytime we use this function, we know the piece already exist.
+    return getType_Piece(getPiece_Cell(search_LinearQuadTree(map->lqt, x, y), map->base.pieces));
+}
+
+static void free_LinearMap(Map* base)
+{
+    LinearMap* map = (LinearMap*) base;
+    // The pieces aren't owned by the map, only the cells are freed
+    free_LinearQuadTree(map->lqt);
+    free(map);
+}
+
+static int countCells_LinearMap(Map* base)
+{
+    return ((LinearMap*) base)->lqt->nr_nodes;
+}
+
+static void visitCells_LinearMap(Map* base, CellVisitor visitor, void* context)
+{
+    visit_LinearQuadTree(((LinearMap*) base)->lqt, 0, 0, base->size - 1, base->size - 1, visitor, context);
+}
+
+static Cell* findCell_LinearMap(Map* base, int x, int y)
+{
+    return search_LinearQuadTree(((LinearMap*) base)->lqt, x, y);
+}
+
+static Cell* insertCell_LinearMap(Map* base, int x, int y)
+{
+    return insert_LinearQuadTree(((LinearMap*) base)->lqt, x, y);
+}
+
+const MapBackend linearBackend = {
+    .name = "linear",
+    .newMap = new_LinearMap,
+    .addPiece = addPiece_LinearMap,
+    .registerAttack = registerAttack_LinearMap,
+    .registerShot = registerShot_LinearMap,
+    .getPieceStatus = getPieceStatus_LinearMap,
+    .getShotStatus = getShotStatus_LinearMap,
+    .getPieceType = getPieceType_LinearMap,
+    .freeMap = free_LinearMap,
+    .countCells = countCells_LinearMap,
+    .visitCells = visitCells_LinearMap,
+    .findCell = findCell_LinearMap,
+    .insertCell = insertCell_LinearMap
+};
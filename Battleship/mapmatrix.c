@@ -0,0 +1,221 @@
+// Needed for posix_memalign
+#define _POSIX_C_SOURCE 200112L
+
+#include "mapbackend.h"
+
+#include "io.h"
+#include <stdlib.h>
+
+/*
+    Map with the cells in a matrix.
+    All the cells are in one contiguous block, aligned to a cache line, with the cell (x,y) on position x * size + y.
+*/
+typedef struct MatrixMap
+{
+    Map base;
+
+    // Cells of the map
+    Cell* cells;
+} MatrixMap;
+
+// Size of a cache line, the alignment of the block of cells
+#define CACHE_LINE 64
+
+// Returns the cell on position (x,y)
+static Cell* getCell(MatrixMap* map, int x, int y)
+{
+    return &map->cells[x * map->base.size + y];
+}
+
+/*
+    Function that see's if a piece can be added to the map.
+    If it returns 0, than the piece can be added.
+    If it returns 1, than (parts of) the piece would be outside the map
+    If it returns 2, than (parts of) the piece would intersect with previous pieces, that is, there is already a (at least one) piece (or parts of), where this piece lies.
+    Note: Nothing to the map happens, in all the cases.
+*/
+static int canAddPiece(MatrixMap* map, Piece* piece)
+{
+    /*
+        Check if the attack is inside the map.
+        Note: Check this first. or the next call made 'getStatus_Piece', may cause a segmentation fault.
+    */
+    if(piece->posX < 0 || piece->posX >= map->base.size || piece->posY < 0 || piece->posY >= map->base.size )
+        return 1;
+
+    for(int x = piece->posX - 2; x <= piece->posX + 2; x++) {
+        for(int y = piece->posY - 2; y <= piece->posY + 2; y++) {
+            // For the positions (x,y) that we need to attactch the piece, we need to see if:
+            if(getStatus_Piece(piece, x, y) == 1) {
+                // it's a valid position on the map
+                if(x < 0 || x >= map->base.size || y < 0 || y >= map->base.size)
+                    return 1;
+                // and there's a piece there already.
+                if(hasPiece_Cell(getCell(map, x, y)))
+                    return 2;
+            }
+        }
+    }
+    // At this point, we know that the piece can be attactched
+    return 0;
+}
+
+// Simple function to attactch the piece to the map.
+static void attactchPiece(MatrixMap* map, Piece* piece)
+{
+    for(int i = piece->posX - 2; i <= piece->posX + 2; i++)
+        for(int j = piece->posY - 2; j <= piece->posY + 2; j++)
+            if(getStatus_Piece(piece, i, j) == 1)
+                setPiece_Cell(getCell(map, i, j), map->base.pieces, piece);
+}
+
+
+static Map* new_MatrixMap(int map_size, Piece* pieces)
+{
+    MatrixMap* map = (MatrixMap*) malloc(sizeof(MatrixMap));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(map == NULL)
+        prompt_IO(ERROR_IO, "mapmatrix.c, new_MatrixMap(): malloc failed");
+
+    // Update size of the map
+    map->base.size = map_size;
+    map->base.pieces = pieces;
+
+    // All the cells are allocated at once
+    void* cells;
+    // Case posix_memalign failed, print that posix_memalign failed and abort execution
+    if(posix_memalign(&cells, CACHE_LINE, map->base.size * map->base.size * sizeof(Cell)) != 0)
+        prompt_IO(ERROR_IO, "mapmatrix.c, new_MatrixMap(): posix_memalign failed");
+    map->cells = (Cell*) cells;
+
+    for(int i = 0; i < map->base.size * map->base.size; i++)
+        init_Cell(&map->cells[i]);
+
+    return &map->base;
+}
+
+
+static int addPiece_MatrixMap(Map* base, Piece* piece)
+{
+    MatrixMap* map = (MatrixMap*) base;
+    int resultAddingPiece = canAddPiece(map, piece);
+    // If the result of the function canAddPiece is 0, then the piece can be added and it's added
+    if(resultAddingPiece == 0)
+        attactchPiece(map, piece);
+    return resultAddingPiece;
+}
+
+static int getPieceStatus_MatrixMap(Map* base, int x, int y)
+{
+    MatrixMap* map = (MatrixMap*) base;
+    // Case there's no piece, return 0
+    if(!hasPiece_Cell(getCell(map, x, y))) return 0;
+    // Case there's a piece, return the status of the piece on position (x,y)
+    return getStatus_Piece(getPiece_Cell(getCell(map, x, y), map->base.pieces), x, y);
+}
+
+static int getShotStatus_MatrixMap(Map* base, int x, int y)
+{
+    MatrixMap* map = (MatrixMap*) base;
+    return getShot_Cell(getCell(map, x, y));
+}
+
+static int registerAttack_MatrixMap(Map* base, int x, int y)
+{
+    MatrixMap* map = (MatrixMap*) base;
+    /*
+        Attack outside the map.
+        This needs to be verified first, to not cause a segmentation fault
+        on the call made next to the function getPieceStatus,
+        which would try to acess invalid positions on the map.
+    */
+    if(x < 0 || x >= map->base.size || y < 0 || y >= map->base.size)
+        return -1;
+
+    switch(getPieceStatus_MatrixMap(base, x, y)) {
+        // Case there's no piece
+        case 0: return 0;
+
+        // Case there's a piece, not hitted
+        case 1: {
+            Piece* piece = getPiece_Cell(getCell(map, x, y), map->base.pieces);
+
+            // Mark on the state of the piece that the position was hitted.
+            registerAttack_Piece(piece, x, y);
+
+            // Return accordingly to piece hitted
+            switch(getType_Piece(piece)) {
+                case 'I': return 1;
+                case 'P': return 2;
+                case 'T': return 3;
+                case 'X': return 4;
+                case 'Z': return 5;
+                default: prompt_IO(ERROR_IO, "mapmatrix.c, registerAttack_MatrixMap(): invalid piece type");
+            }
+        }
+        // Case there's a piece, but already hitted
+        case 2: return 6;
+
+        // Case it's an invalid piece status: notify and abort execution
+        default: prompt_IO(ERROR_IO, "mapmatrix.c, registerAttack_MatrixMap(): invalid piece status");
+    }
+
+    // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
+    return 0;
+}
+
+static void registerShot_MatrixMap(Map* base, int x, int y, byte b)
+{
+    MatrixMap* map = (MatrixMap*) base;
+    setShot_Cell(getCell(map, x, y), b);
+}
+
+static char getPieceType_MatrixMap(Map* base, int x, int y)
+{
+    MatrixMap* map = (MatrixMap*) base;
+    return getType_Piece(getPiece_Cell(getCell(map, x, y), map->base.pieces));
+}
+
+static void free_MatrixMap(Map* base)
+{
+    MatrixMap* map = (MatrixMap*) base;
+    // All the cells are freed at once (the pieces aren't owned by the map)
+    free(map->cells);
+    free(map);
+}
+
+static int countCells_MatrixMap(Map* base)
+{
+    return base->size * base->size;
+}
+
+static void visitCells_MatrixMap(Map* base, CellVisitor visitor, void* context)
+{
+    MatrixMap* map = (MatrixMap*) base;
+    for(int x = 0; x < base->size; x++)
+        for(int y = 0; y < base->size; y++)
+            if(!visitor(getCell(map, x, y), x, y, context))
+                return;
+}
+
+// All the cells are stored, so finding a cell is the same as inserting it
+static Cell* insertCell_MatrixMap(Map* base, int x, int y)
+{
+    return getCell((MatrixMap*) base, x, y);
+}
+
+const MapBackend matrixBackend = {
+    .name = "matrix",
+    .newMap = new_MatrixMap,
+    .addPiece = addPiece_MatrixMap,
+    .registerAttack = registerAttack_MatrixMap,
+    .registerShot = registerShot_MatrixMap,
+    .getPieceStatus = getPieceStatus_MatrixMap,
+    .getShotStatus = getShotStatus_MatrixMap,
+    .getPieceType = getPieceType_MatrixMap,
+    .freeMap = free_MatrixMap,
+    .countCells = countCells_MatrixMap,
+    .visitCells = visitCells_MatrixMap,
+    .findCell = insertCell_MatrixMap,
+    .insertCell = insertCell_MatrixMap
+};
@@ -0,0 +1,244 @@
+#include "mapbackend.h"
+
+#include "quadtree.h"
+#include "pool.h"
+#include "io.h"
+#include <stdlib.h>
+
+// Map with the cells in a quadtree
+typedef struct QuadTreeMap
+{
+    Map base;
+
+    // Cells of the map
+    QuadTree* qt;
+
+    // Pool where the quadtree and the cells are allocated
+    Pool* pool;
+
+    // Number of cells allocated
+    int nr_cells;
+} QuadTreeMap;
+
+/*
+    Function that see's if a piece can be added to the map.
+    If it returns 0, than the piece can be added.
+    If it returns 1, than (parts of) the piece would be outside the map
+    If it returns 2, than (parts of) the piece would intersect with previous pieces, that is, there is already a (at least one) piece (or parts of), where this piece lies.
+    Note: Nothing to the map happens, in all the cases.
+    The intersection is checked with one traversal of the quadtree, over the square of the piece.
+*/
+static int canAddPiece(QuadTreeMap* map, Piece* piece)
+{
+    for(int x = piece->posX - 2; x <= piece->posX + 2; x++)
+        for(int y = piece->posY - 2; y <= piece->posY + 2; y++)
+            // For the positions (x,y) that we need to attactch the piece, we need to see if it's a valid position on the map
+            if(getStatus_Piece(piece, x, y) == 1 && (x < 0 || x >= map->base.size || y < 0 || y >= map->base.size))
+                return 1;
+
+    // and if there's a piece there already.
+    Overlap overlap = { piece, false };
+    visit_QuadTree(map->qt, piece->posX - 2, piece->posY - 2, piece->posX + 2, piece->posY + 2, findOverlap_Map, &overlap);
+    if(overlap.found)
+        return 2;
+
+    // At this point, we know that the piece can be attactched
+    return 0;
+}
+
+// Allocs a new cell from the pool of the map, with the field piece set to NULL and the field shot set to 0
+static Cell* newCell(QuadTreeMap* map)
+{
+    Cell* cell = (Cell*) alloc_Pool(map->pool, sizeof(Cell));
+    init_Cell(cell);
+    map->nr_cells++;
+    return cell;
+}
+
+// Simple function to attactch the piece to the map.
+static void attactchPiece(QuadTreeMap* map, Piece* piece)
+{
+    for(int i = piece->posX - 2; i <= piece->posX + 2; i++) {
+        for(int j = piece->posY - 2; j <= piece->posY + 2; j++) {
+            if(getStatus_Piece(piece, i, j) == 1){
+                Cell* cell = newCell(map);
+                setPiece_Cell(cell, map->base.pieces, piece);
+                insert_QuadTree(map->qt, cell, i, j);
+            }
+        }  
+    }
+}
+
+static Map* new_QuadTreeMap(int size, Piece* pieces)
+{
+    QuadTreeMap* map = (QuadTreeMap*) malloc(sizeof(QuadTreeMap));
+    if(map == NULL)
+        prompt_IO(ERROR_IO, "mapquadtree.c, new_QuadTreeMap(): malloc failed");
+    
+    map->base.size = size;
+    map->base.pieces = pieces;
+    // The first slab of the pool is enough for the quadtree of a map with a few pieces
+    map->pool = new_Pool(16384);
+    map->qt = new_QuadTree(size, map->pool);
+    map->nr_cells = 0;
+   
+    return &map->base;
+}
+
+
+static int addPiece_QuadTreeMap(Map* base, Piece* piece)
+{
+    QuadTreeMap* map = (QuadTreeMap*) base;
+  int resultAddingPiece = canAddPiece(map, piece);
+    // If the result of the function canAddPiece is 0, then the piece can be added and it's added
+    if(resultAddingPiece == 0) 
+        attactchPiece(map, piece);
+    return resultAddingPiece;
+  return -1;
+}
+
+static int registerAttack_QuadTreeMap(Map* base, int x, int y)
+{
+    QuadTreeMap* map = (QuadTreeMap*) base;
+    // Attack outside the map.
+    if(x < 0 || x >= map->base.size || y < 0 || y >= map->base.size)
+        return -1;
+    
+    // Search for the cell, on position (x,y)
+    Cell* cell_found = search_QuadTree(map->qt, x, y);
+    
+    // Case there's no piece
+    if(cell_found == NULL || !hasPiece_Cell(cell_found)) return 0; 
+
+    // Case there's a piece
+    Piece* piece = getPiece_Cell(cell_found, map->base.pieces);
+    int val = getStatus_Piece(piece, x, y);
+    switch(val) {
+        // Case there's a piece, hitted
+        case 1: {
+            // Mark on the state of the piece that the position was hitted.
+            registerAttack_Piece(piece, x, y);
+
+            // Return accordingly to piece hitted
+            switch(getType_Piece(piece)) {
+                case 'I': return 1;
+                case 'P': return 2;
+                case 'T': return 3;
+                case 'X': return 4;
+                case 'Z': return 5;
+                default: prompt_IO(ERROR_IO, "mapquadtree.c, registerAttack_QuadTreeMap(): invalid piece type");
+            }
+        }
+        // Case there's a piece, but already hitted
+        case 2: return 6;
+        // Case it's an invalid piece status: notify and abort execution
+        default: prompt_IO(ERROR_IO, "mapquadtree.c, registerAttack_QuadTreeMap(): invalid piece status");
+    }
+
+    // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
+    return 0;
+}
+
+static void registerShot_QuadTreeMap(Map* base, int x, int y, byte b)
+{
+    QuadTreeMap* map = (QuadTreeMap*) base;
+  // Get the node on position (x,y), inserted on the same descent if there's none.
+  QuadNode* node = insertNode_QuadTree(map->qt, x, y);
+  if(node == NULL)
+    return;
+
+  // If the node is new, it has no cell yet, we must add one.
+  if(node->cell == NULL)
+    node->cell = newCell(map);
+  setShot_Cell(node->cell, b);
+}
+
+static int getPieceStatus_QuadTreeMap(Map* base, int x, int y)
+{
+    QuadTreeMap* map = (QuadTreeMap*) base;
+  // Search for the cell on position (x,y).
+  Cell* cell_found = search_QuadTree(map->qt, x, y);
+  
+  // Case no cell or piece.
+  if(cell_found == NULL || !hasPiece_Cell(cell_found)) 
+    return 0;
+  // Case there's a piece.
+  else
+    return getStatus_Piece(getPiece_Cell(cell_found, map->base.pieces), x, y);
+}
+
+static int getShotStatus_QuadTreeMap(Map* base, int x, int y)
+{
+    QuadTreeMap* map = (QuadTreeMap*) base;
+  // Search for the cell on position (x,y).
+  Cell* cell_found = search_QuadTree(map->qt, x, y);
+  
+  // Case there's no cell.
+  if(cell_found == NULL)
+    return 0;
+  // Case there's a cell.
+  else
+    return getShot_Cell(cell_found);
+}
+
+static char getPieceType_QuadTreeMap(Map* base, int x, int y)
+{
+    QuadTreeMap* map = (QuadTreeMap*) base;
+    // Search for the cell on position (x,y).
+    Cell* cell = search_QuadTree(map->qt, x, y);
+
+    // As stated in the header file, this function doesn't validate if the piece exists, 
+    // since everytime we use this function, we know the piece already exist.
+    return getType_Piece(getPiece_Cell(cell, map->base.pieces));
+}
+
+static void free_QuadTreeMap(Map* base)
+{
+    QuadTreeMap* map = (QuadTreeMap*) base;
+  // The quadtree and the cells are all in the pool (and the pieces aren't owned by the map)
+  free_Pool(map->pool);
+  free(map);
+}
+
+static int countCells_QuadTreeMap(Map* base)
+{
+    return ((QuadTreeMap*) base)->nr_cells;
+}
+
+static void visitCells_QuadTreeMap(Map* base, CellVisitor visitor, void* context)
+{
+    visit_QuadTree(((QuadTreeMap*) base)->qt, 0, 0, base->size - 1, base->size - 1, visitor, context);
+}
+
+static Cell* findCell_QuadTreeMap(Map* base, int x, int y)
+{
+    return search_QuadTree(((QuadTreeMap*) base)->qt, x, y);
+}
+
+static Cell* insertCell_QuadTreeMap(Map* base, int x, int y)
+{
+    QuadTreeMap* map = (QuadTreeMap*) base;
+    // One descent: the node is created (with no cell) if it's missing
+    QuadNode* node = insertNode_QuadTree(map->qt, x, y);
+    if(node == NULL)
+        return NULL;
+    if(node->cell == NULL)
+        node->cell = newCell(map);
+    return node->cell;
+}
+
+const MapBackend quadtreeBackend = {
+    .name = "quadtree",
+    .newMap = new_QuadTreeMap,
+    .addPiece = addPiece_QuadTreeMap,
+    .registerAttack = registerAttack_QuadTreeMap,
+    .registerShot = registerShot_QuadTreeMap,
+    .getPieceStatus = getPieceStatus_QuadTreeMap,
+    .getShotStatus = getShotStatus_QuadTreeMap,
+    .getPieceType = getPieceType_QuadTreeMap,
+    .freeMap = free_QuadTreeMap,
+    .countCells = countCells_QuadTreeMap,
+    .visitCells = visitCells_QuadTreeMap,
+    .findCell = findCell_QuadTreeMap,
+    .insertCell = insertCell_QuadTreeMap
+};
@@ -0,0 +1,318 @@
+#include "montecarlo.h"
+
+#include "scheduler.h"
+#include "utils.h"
+#include "io.h"
+#include <stdlib.h>
+
+// Number of random placements tried for a piece, before counting all the legal placements (see placeFree)
+#define MAX_TRIES_MONTECARLO 32
+
+// Max number of placements tried to cover the hits of one fleet (see coverHits)
+#define MAX_NODES_MONTECARLO 200
+
+MonteCarlo* new_MonteCarlo(Player* target, Random* random, int nr_threads, double budget, int min_fleets)
+{
+    // Case the number of threads isn't valid, notify and abort execution
+    if(nr_threads <= 0 || nr_threads > MAX_THREADS_MONTECARLO)
+        prompt_IO(ERROR_IO, "montecarlo.c, new_MonteCarlo(): invalid number of threads");
+
+    MonteCarlo* montecarlo = (MonteCarlo*) malloc(sizeof(MonteCarlo));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(montecarlo == NULL)
+        prompt_IO(ERROR_IO, "montecarlo.c, new_MonteCarlo(): malloc failed");
+
+    montecarlo->density = new_Density(target, random);
+    montecarlo->budget = budget;
+    montecarlo->min_fleets = min_fleets;
+    montecarlo->nr_threads = nr_threads;
+
+    int size = montecarlo->density->size;
+    montecarlo->hits = (int*) malloc(2 * size * size * sizeof(int));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(montecarlo->hits == NULL)
+        prompt_IO(ERROR_IO, "montecarlo.c, new_MonteCarlo(): malloc of the hits failed");
+    montecarlo->hit_types = montecarlo->hits + size * size;
+
+    // Each type has 4 orientations, at most, each with size * size corners, at most
+    montecarlo->free_placements[0] = (int*) malloc(5 * 4 * size * size * sizeof(int));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(montecarlo->free_placements[0] == NULL)
+        prompt_IO(ERROR_IO, "montecarlo.c, new_MonteCarlo(): malloc of the placements failed");
+    for(int type = 1; type < 5; type++)
+        montecarlo->free_placements[type] = montecarlo->free_placements[type - 1] + 4 * size * size;
+
+    for(int t = 0; t < nr_threads; t++) {
+        Sampler* sampler = &montecarlo->samplers[t];
+        split_Random(random, &sampler->random);
+        sampler->placement = new_Placement(size);
+        sampler->occupied = (int*) malloc(size * size * sizeof(int));
+        // Case malloc failed, print that malloc failed and abort execution
+        if(sampler->occupied == NULL)
+            prompt_IO(ERROR_IO, "montecarlo.c, new_MonteCarlo(): malloc of the sampler failed");
+    }
+
+    return montecarlo;
+}
+
+// Returns true if the orientation fits with the corner on (x,y): inside the map, and not on 'blocked' nor on 'placed'
+static bool fits(MonteCarlo* montecarlo, Orientation* orientation, int x, int y, uint64_t blocked[], uint64_t placed[])
+{
+    int size = montecarlo->density->size;
+    if(x < 0 || y < 0 || x + orientation->height > size || y + orientation->width > size)
+        return false;
+
+    for(int i = 0; i < orientation->height; i++)
+        if((blocked[x + i] | placed[x + i]) & (orientation->rows[i] << y))
+            return false;
+    return true;
+}
+
+/*
+    Covers, with pieces of their types, the hits from the number 'next' on (of the list of hits of the bot) not covered yet by the pieces placed
+    (the rows of 'placed'), with 'left' pieces of each type still to place, and 'uncovered' hits of each type not covered yet.
+    The placements over each hit are tried in random order, going back when some hit can't be covered, at most on MAX_NODES_MONTECARLO placements.
+    Returns true, with the pieces on 'placed' and 'left' updated, if all the hits were covered, otherwise returns false.
+*/
+static bool coverHits(MonteCarlo* montecarlo, Sampler* sampler, int next, uint64_t placed[], int left[5], int uncovered[5], int* p_nodes)
+{
+    Placement* placement = sampler->placement;
+    int size = montecarlo->density->size;
+
+    // The next hit not covered
+    while(next < montecarlo->nr_hits && ((placed[montecarlo->hits[next] / size] >> (montecarlo->hits[next] % size)) & 1))
+        next++;
+    if(next == montecarlo->nr_hits)
+        return true;
+    if(++*p_nodes > MAX_NODES_MONTECARLO)
+        return false;
+
+    int type = montecarlo->hit_types[next];
+    int x = montecarlo->hits[next] / size, y = montecarlo->hits[next] % size;
+    uint64_t* hits = montecarlo->density->hits[type];
+
+    // Each cell (i,j) of each orientation gives one placement over (x,y): the one with the corner on (x - i, y - j)
+    Orientation* orientations[20];
+    int corners_x[20], corners_y[20];
+    int nr_legal = 0;
+    for(int k = 0; k < placement->nr_orientations[type]; k++) {
+        Orientation* orientation = &placement->orientations[type][k];
+        for(int i = 0; i < orientation->height; i++)
+            for(int j = 0; j < orientation->width; j++)
+                if(((orientation->rows[i] >> j) & 1) && fits(montecarlo, orientation, x - i, y - j, montecarlo->blocked[type], placed)) {
+                    orientations[nr_legal] = orientation;
+                    corners_x[nr_legal] = x - i;
+                    corners_y[nr_legal] = y - j;
+                    nr_legal++;
+                }
+    }
+
+    // Try the placements in random order: the one chosen goes to the end of the ones left
+    for(int nr_left = nr_legal; nr_left > 0; nr_left--) {
+        int chosen = range_Random(&sampler->random, nr_left);
+        Orientation* orientation = orientations[chosen];
+        int corner_x = corners_x[chosen], corner_y = corners_y[chosen];
+        orientations[chosen] = orientations[nr_left - 1];
+        corners_x[chosen] = corners_x[nr_left - 1];
+        corners_y[chosen] = corners_y[nr_left - 1];
+
+        int nr_covered = 0;
+        for(int i = 0; i < orientation->height; i++) {
+            nr_covered += __builtin_popcountll(hits[corner_x + i] & (orientation->rows[i] << corner_y));
+            placed[corner_x + i] |= orientation->rows[i] << corner_y;
+        }
+        left[type]--;
+        uncovered[type] -= nr_covered;
+
+        // Each piece left covers 5 hits, at most
+        if(uncovered[type] <= 5 * left[type] && coverHits(montecarlo, sampler, next + 1, placed, left, uncovered, p_nodes))
+            return true;
+
+        for(int i = 0; i < orientation->height; i++)
+            placed[corner_x + i] &= ~(orientation->rows[i] << corner_y);
+        left[type]++;
+        uncovered[type] += nr_covered;
+    }
+    return false;
+}
+
+/*
+    Places, on the engine, a piece of the type at random (uniformly among the legal placements). Returns false if there's no legal placement.
+    Placements of the list of the bot (the ones on cells not attacked) are tried first, since most don't touch the other pieces,
+    and only then all the legal placements are counted.
+*/
+static bool placeFree(MonteCarlo* montecarlo, Sampler* sampler, int type)
+{
+    Placement* placement = sampler->placement;
+    if(montecarlo->nr_free[type] == 0)
+        return false;
+
+    for(int tries = 0; tries < MAX_TRIES_MONTECARLO; tries++) {
+        int free_placement = montecarlo->free_placements[type][range_Random(&sampler->random, montecarlo->nr_free[type])];
+        Orientation* orientation = &placement->orientations[type][free_placement >> 16];
+        int x = (free_placement >> 8) & 255, y = free_placement & 255;
+        if(fits_Placement(placement, orientation, x, y)) {
+            take_Placement(placement, orientation, x, y);
+            return true;
+        }
+    }
+
+    Piece piece;
+    return random_Placement(placement, type, &piece, &sampler->random);
+}
+
+bool draw_MonteCarlo(MonteCarlo* montecarlo, Sampler* sampler)
+{
+    Density* density = montecarlo->density;
+    Placement* placement = sampler->placement;
+    int size = density->size;
+
+    // First, the hits: the pieces sunk are the same on every fleet, and each other hit gets a piece of its type over it
+    uint64_t placed[MAX_SIZE_PLACEMENT];
+    for(int x = 0; x < size; x++)
+        placed[x] = density->sunk[x];
+    int left[5], uncovered[5];
+    for(int type = 0; type < 5; type++) {
+        left[type] = density->nr_per_piece[type] - density->nr_sunk[type];
+        uncovered[type] = density->nr_hits[type] - 5 * density->nr_sunk[type];
+    }
+
+    int nr_nodes = 0;
+    if(!coverHits(montecarlo, sampler, 0, placed, left, uncovered, &nr_nodes))
+        return false;
+
+    // Then, the other pieces, anywhere not attacked
+    for(int x = 0; x < size; x++)
+        placement->taken[x] = density->attacked[x] | placed[x];
+    for(int type = 0; type < 5; type++)
+        for(int n = 0; n < left[type]; n++)
+            if(!placeFree(montecarlo, sampler, type))
+                return false;
+
+    // The cells not attacked with a piece of the fleet
+    for(int x = 0; x < size; x++) {
+        uint64_t cells = placement->taken[x] & ~density->attacked[x];
+        while(cells != 0) {
+            sampler->occupied[x * size + __builtin_ctzll(cells)]++;
+            cells &= cells - 1;
+        }
+    }
+    sampler->nr_fleets++;
+    return true;
+}
+
+void prepare_MonteCarlo(MonteCarlo* montecarlo)
+{
+    Density* density = montecarlo->density;
+    int size = density->size;
+
+    // The pieces sunk, where each type can't be, and the list of the other hits
+    findSunk_Density(density);
+    montecarlo->nr_hits = 0;
+    for(int type = 0; type < 5; type++) {
+        for(int x = 0; x < size; x++) {
+            montecarlo->blocked[type][x] = density->attacked[x] & ~density->hits[type][x];
+            for(uint64_t cells = density->hits[type][x] & ~density->sunk[x]; cells != 0; cells &= cells - 1) {
+                montecarlo->hits[montecarlo->nr_hits] = x * size + __builtin_ctzll(cells);
+                montecarlo->hit_types[montecarlo->nr_hits] = type;
+                montecarlo->nr_hits++;
+            }
+        }
+    }
+
+    // and the placements on cells not attacked, of each type
+    Placement* placement = montecarlo->samplers[0].placement;
+    for(int x = 0; x < size; x++)
+        placement->taken[x] = density->attacked[x];
+    for(int type = 0; type < 5; type++) {
+        montecarlo->nr_free[type] = 0;
+        for(int k = 0; k < placement->nr_orientations[type]; k++)
+            for(int x = 0; x < size; x++)
+                for(uint64_t anchors = anchors_Placement(placement, &placement->orientations[type][k], x); anchors != 0; anchors &= anchors - 1)
+                    montecarlo->free_placements[type][montecarlo->nr_free[type]++] = (k << 16) | (x << 8) | __builtin_ctzll(anchors);
+    }
+}
+
+// Task of the thread drawing fleets with the sampler number 'task', till the time budget is over (but at least min_fleets tries)
+static void drawFleets(int task, int thread, void* context)
+{
+    MonteCarlo* montecarlo = (MonteCarlo*) context;
+    Sampler* sampler = &montecarlo->samplers[task];
+
+    for(int tries = 0; tries < montecarlo->min_fleets || now_Scheduler() < montecarlo->deadline; tries++)
+        draw_MonteCarlo(montecarlo, sampler);
+}
+
+void attack_MonteCarlo(Game* game, int id_player, int* p_x, int* p_y, void* context)
+{
+    MonteCarlo* montecarlo = (MonteCarlo*) context;
+    Density* density = montecarlo->density;
+    int size = density->size;
+
+    // The result of the last attack is on the shots map of the player
+    if(density->last_x >= 0)
+        update_Density(density, density->last_x, density->last_y, getShotStatus_Player(game->players[id_player], density->last_x, density->last_y));
+
+    prepare_MonteCarlo(montecarlo);
+    for(int t = 0; t < montecarlo->nr_threads; t++) {
+        montecarlo->samplers[t].nr_fleets = 0;
+        for(int c = 0; c < size * size; c++)
+            montecarlo->samplers[t].occupied[c] = 0;
+    }
+
+    montecarlo->deadline = now_Scheduler() + montecarlo->budget;
+    if(montecarlo->nr_threads == 1)
+        drawFleets(0, 0, montecarlo);
+    else
+        run_Scheduler(montecarlo->nr_threads, montecarlo->nr_threads, drawFleets, montecarlo);
+
+    int nr_fleets = 0;
+    for(int t = 0; t < montecarlo->nr_threads; t++)
+        nr_fleets += montecarlo->samplers[t].nr_fleets;
+
+    if(nr_fleets == 0) {
+        // No fleet could be drawn, attack by density
+        compute_Density(density);
+        choose_Density(density, p_x, p_y);
+    } else {
+        // The cell not attacked on most fleets, with the ties broken uniformly (as in choose_Density)
+        int best = -1, nr_best = 0;
+        for(int x = 0; x < size; x++) {
+            for(int y = 0; y < size; y++) {
+                if((density->attacked[x] >> y) & 1)
+                    continue;
+
+                int occupied = 0;
+                for(int t = 0; t < montecarlo->nr_threads; t++)
+                    occupied += montecarlo->samplers[t].occupied[x * size + y];
+                if(occupied > best) {
+                    best = occupied;
+                    nr_best = 0;
+                }
+                if(occupied == best && range_Random(&density->random, ++nr_best) == 0) {
+                    *p_x = x;
+                    *p_y = y;
+                }
+            }
+        }
+
+        // Case all cells were already attacked (the game would be over), notify and abort execution
+        if(best < 0)
+            prompt_IO(ERROR_IO, "montecarlo.c, attack_MonteCarlo(): no cells left to attack");
+    }
+
+    density->last_x = *p_x;
+    density->last_y = *p_y;
+}
+
+void free_MonteCarlo(MonteCarlo* montecarlo)
+{
+    for(int t = 0; t < montecarlo->nr_threads; t++) {
+        free_Placement(montecarlo->samplers[t].placement);
+        free(montecarlo->samplers[t].occupied);
+    }
+    free(montecarlo->hits);
+    free(montecarlo->free_placements[0]);
+    free_Density(montecarlo->density);
+    free(montecarlo);
+}
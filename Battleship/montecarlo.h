@@ -0,0 +1,86 @@
+/*
+  montecarlo.h
+  Computer player that attacks by Monte Carlo sampling of the hidden fleet.
+
+  On each attack, it draws many complete fleets (all the pieces of the setup) consistent with what it saw so far:
+  no piece on a miss, every hit covered by a piece of the type hitted, and no piece of another type over it.
+  Then it attacks the cell not attacked yet that is occupied on most of the fleets drawn.
+
+  A fleet is drawn in two steps: first, the pieces sunk (groups of 5 hits with the format of their type) are kept, and each hit not covered yet gets a piece of its type, chosen at random among the placements over it
+  (going back if some hit can't be covered); then the other pieces are placed at random among the placements on cells not attacked (see placement.h). Fleets where some piece doesn't fit are discarded.
+  The fleets are drawn by several threads (see scheduler.h), each with its own generator, till the time budget of the attack is over.
+  If no fleet could be drawn, it attacks as the bot of density.h, which also keeps what was seen.
+*/
+
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include "density.h"
+
+// Max number of threads drawing fleets
+#define MAX_THREADS_MONTECARLO 64
+
+// What each thread uses to draw fleets
+typedef struct Sampler
+{
+    // Generator of the thread, split from the one of the bot
+    Random random;
+
+    // Engine where the pieces of the fleet are placed
+    Placement* placement;
+
+    // Number of fleets drawn, and, for each cell (x * size + y), the number of those fleets with a piece on it
+    int nr_fleets;
+    int* occupied;
+} Sampler;
+
+// Definition of the bot
+typedef struct MonteCarlo
+{
+    // What was seen so far, with the pieces already sunk, the same on all the fleets (and the attack used when no fleet is drawn)
+    Density* density;
+
+    // What the threads need of what was seen, computed on each attack: the cells where each type of piece can't be
+    // (the ones attacked, except the hits of the type), and the hits (x * size + y), ordered by type, row and column, with their types
+    uint64_t blocked[5][MAX_SIZE_PLACEMENT];
+    int* hits;
+    int* hit_types;
+    int nr_hits;
+    // The placements of each type on cells not attacked ((orientation << 16) | (x << 8) | y, with the corner on (x,y))
+    int* free_placements[5];
+    int nr_free[5];
+
+    // Time budget of each attack, in seconds, and least number of fleets drawn by each thread (the budget can be 0, so the attacks don't depend on the time)
+    double budget;
+    int min_fleets;
+
+    // Threads drawing fleets
+    int nr_threads;
+    Sampler samplers[MAX_THREADS_MONTECARLO];
+
+    // End of the time budget of the current attack (monotonic clock, in seconds)
+    double deadline;
+} MonteCarlo;
+
+/*
+  Allocs a new bot, to attack the map of the player 'target' (only its size and the types of its pieces are seen), with generators split from 'random'.
+  Each attack draws fleets on 'nr_threads' threads (1 to MAX_THREADS_MONTECARLO), for 'budget' seconds, but at least 'min_fleets' per thread.
+*/
+MonteCarlo* new_MonteCarlo(Player* target, Random* random, int nr_threads, double budget, int min_fleets);
+
+// Prepares, with what was seen so far, what the threads need to draw the fleets (done on each attack, before drawing)
+void prepare_MonteCarlo(MonteCarlo* montecarlo);
+
+/*
+  Draws one fleet consistent with what was seen (as of the last prepare_MonteCarlo), with the sampler, and adds its cells to the sampler.
+  Returns false if some piece didn't fit (and nothing is added), otherwise returns true.
+*/
+bool draw_MonteCarlo(MonteCarlo* montecarlo, Sampler* sampler);
+
+// Attacker (see game.h) where the bot, given as context, registers the result of its last attack and attacks the cell occupied on most fleets
+void attack_MonteCarlo(Game* game, int id_player, int* p_x, int* p_y, void* context);
+
+// Frees the bot
+void free_MonteCarlo(MonteCarlo* montecarlo);
+
+#endif
@@ -0,0 +1,51 @@
+#include "options.h"
+
+#include "map.h"
+#include "io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* get_Options(int argc, char* argv[], const char* name, const char* variable)
+{
+    const char* value = (variable != NULL) ? getenv(variable) : NULL;
+    size_t length = strlen(name);
+
+    for(int i = 1; i < argc; i++) {
+        if(strncmp(argv[i], "--", 2) != 0 || strncmp(argv[i] + 2, name, length) != 0)
+            continue;
+
+        // '--<name>=<value>'
+        if(argv[i][2 + length] == '=')
+            value = argv[i] + 3 + length;
+        // '--<name> <value>'
+        else if(argv[i][2 + length] == '\0' && i + 1 < argc)
+            value = argv[++i];
+    }
+    return value;
+}
+
+uint64_t getNumber_Options(int argc, char* argv[], const char* name, const char* variable, uint64_t default_value)
+{
+    const char* text = get_Options(argc, argv, name, variable);
+    if(text == NULL)
+        return default_value;
+
+    char* end;
+    uint64_t number = strtoull(text, &end, 10);
+    // Case it isn't a non-negative integer, notify and abort execution
+    if(*text == '\0' || *text == '-' || *end != '\0') {
+        char message[128];
+        snprintf(message, sizeof(message), "[System] Invalid value of the option '--%s'. It must be a non-negative integer.", name);
+        prompt_IO(ERROR_IO, message);
+    }
+    return number;
+}
+
+void chooseBackend_Options(int argc, char* argv[])
+{
+    const char* name = get_Options(argc, argv, "map", "BATTLESHIP_MAP");
+
+    if(name != NULL && !setBackend_Map(name))
+        prompt_IO(ERROR_IO, "[System] Unknown map backend. Choose 'quadtree', 'matrix', 'bitboard', 'linear' or 'adaptive'.");
+}
@@ -0,0 +1,32 @@
+/*
+  options.h
+  Options of the command line, shared by the executables (game and simulate).
+
+  An option is given as '--<name> <value>' or '--<name>=<value>'.
+  If it isn't given, it's taken from an environment variable, if there's one for it.
+*/
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdint.h>
+
+/*
+  Returns the value of the option 'name' (without the '--'), or, if it isn't given, the value of the environment variable 'variable'
+  ('variable' can be NULL, for options without environment variable). Returns NULL if neither is given.
+*/
+const char* get_Options(int argc, char* argv[], const char* name, const char* variable);
+
+/*
+  Returns the value of the option 'name' (as in get_Options) as a non-negative integer, or 'default_value' if it isn't given.
+  If the value isn't a non-negative integer, notifies and aborts execution.
+*/
+uint64_t getNumber_Options(int argc, char* argv[], const char* name, const char* variable, uint64_t default_value);
+
+/*
+  Chooses the backend of the maps, with the option 'map' (or the environment variable BATTLESHIP_MAP).
+  If it isn't given, the default backend is kept. If the backend doesn't exist, notifies and aborts execution.
+*/
+void chooseBackend_Options(int argc, char* argv[]);
+
+#endif
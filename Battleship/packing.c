@@ -0,0 +1,170 @@
+#include "packing.h"
+
+#include "placement.h"
+#include "utils.h"
+#include "io.h"
+#include <stdlib.h>
+
+/*
+    Max number of cells decided by the search, before it gives up.
+    The fleets of the game (at most one piece per 25 cells) are packed without backtracking, but some fleets near the
+    max density (a map fully tiled) may need an exponential search, so this keeps the answer within a few milliseconds.
+*/
+#define MAX_NODES_PACKING 200000
+
+// State of the search
+typedef struct Packing
+{
+    // Cells taken by the pieces already placed
+    Placement* placement;
+
+    // Column of the first cell of the top row of each orientation
+    int anchor[5][4];
+
+    // Number of pieces per type left to place, and all of them
+    int nr_per_piece[5];
+    int nr_left;
+
+    // Number of cells that can still be left empty
+    int empty_left;
+
+    // Number of cells decided so far
+    long nr_nodes;
+
+    // Pieces placed (type, orientation and top-left corner), in order
+    int* types;
+    Orientation** orientations;
+    int* xs;
+    int* ys;
+    int nr_placed;
+} Packing;
+
+// Returns true if the cell number 'cell' (x * size + y) is taken
+static bool taken(Packing* packing, int cell)
+{
+    int size = packing->placement->size;
+    return (packing->placement->taken[cell / size] >> (cell % size)) & 1;
+}
+
+/*
+    Searches a packing of the pieces left, where all the cells before the cell number 'cell' are already decided.
+    Returns true if it finds one (and the pieces stay placed), otherwise returns false (and everything is undone).
+    Once the limit of the search is reached, every call returns false, so the search unwinds (nr_nodes tells that it gave up).
+*/
+static bool search(Packing* packing, int cell)
+{
+    Placement* placement = packing->placement;
+    int nr_cells = placement->size * placement->size;
+
+    // The cells already taken are decided
+    while(cell < nr_cells && taken(packing, cell))
+        cell++;
+
+    if(packing->nr_left == 0)
+        return true;
+    if(cell == nr_cells || ++packing->nr_nodes > MAX_NODES_PACKING)
+        return false;
+
+    int x = cell / placement->size, y = cell % placement->size;
+
+    // The cell is the first cell of some piece, that is, the first cell of its top row
+    for(int type = 0; type < 5; type++) {
+        if(packing->nr_per_piece[type] == 0)
+            continue;
+
+        for(int k = 0; k < placement->nr_orientations[type]; k++) {
+            Orientation* orientation = &placement->orientations[type][k];
+            int top_left_y = y - packing->anchor[type][k];
+            if(!fits_Placement(placement, orientation, x, top_left_y))
+                continue;
+
+            take_Placement(placement, orientation, x, top_left_y);
+            packing->nr_per_piece[type]--;
+            packing->nr_left--;
+            packing->types[packing->nr_placed] = type;
+            packing->orientations[packing->nr_placed] = orientation;
+            packing->xs[packing->nr_placed] = x;
+            packing->ys[packing->nr_placed] = top_left_y;
+            packing->nr_placed++;
+
+            if(search(packing, cell + 1))
+                return true;
+
+            packing->nr_placed--;
+            packing->nr_left++;
+            packing->nr_per_piece[type]++;
+            release_Placement(placement, orientation, x, top_left_y);
+        }
+    }
+
+    // or the cell is left empty, if there's still room for it
+    if(packing->empty_left > 0) {
+        packing->empty_left--;
+        if(search(packing, cell + 1))
+            return true;
+        packing->empty_left++;
+    }
+
+    return false;
+}
+
+PackingResult solve_Packing(int size, int nr_per_piece[5], Piece* pieces)
+{
+    Packing packing;
+
+    packing.nr_left = 0;
+    for(int type = 0; type < 5; type++) {
+        // Case it's asked a negative number of pieces, notify and abort execution
+        if(nr_per_piece[type] < 0)
+            prompt_IO(ERROR_IO, "packing.c, solve_Packing(): invalid number of pieces");
+        packing.nr_per_piece[type] = nr_per_piece[type];
+        packing.nr_left += nr_per_piece[type];
+    }
+
+    // Not even the cells are enough
+    packing.empty_left = size * size - 5 * packing.nr_left;
+    if(packing.empty_left < 0)
+        return DOESNT_FIT_PACKING;
+    if(packing.nr_left == 0)
+        return FITS_PACKING;
+
+    packing.placement = new_Placement(size);
+    for(int type = 0; type < 5; type++) {
+        for(int k = 0; k < packing.placement->nr_orientations[type]; k++) {
+            uint64_t top_row = packing.placement->orientations[type][k].rows[0];
+            int column = 0;
+            while(!((top_row >> column) & 1))
+                column++;
+            packing.anchor[type][k] = column;
+        }
+    }
+
+    // All the arrays of the pieces placed in one block
+    packing.nr_placed = 0;
+    packing.nr_nodes = 0;
+    void* block = malloc(packing.nr_left * (3 * sizeof(int) + sizeof(Orientation*)));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(block == NULL)
+        prompt_IO(ERROR_IO, "packing.c, solve_Packing(): malloc failed");
+    packing.orientations = (Orientation**) block;
+    packing.types = (int*) (packing.orientations + packing.nr_left);
+    packing.xs = packing.types + packing.nr_left;
+    packing.ys = packing.xs + packing.nr_left;
+
+    bool found = search(&packing, 0);
+
+    // Write the pieces, with their center and rotation
+    if(found && pieces != NULL) {
+        for(int i = 0; i < packing.nr_placed; i++) {
+            Orientation* orientation = packing.orientations[i];
+            update_Piece(&pieces[i], getType_Utils(packing.types[i]), packing.xs[i] + orientation->center_x, packing.ys[i] + orientation->center_y, orientation->degree);
+        }
+    }
+
+    free(block);
+    free_Placement(packing.placement);
+
+    if(found)
+        return FITS_PACKING;
+    return packing.nr_nodes > MAX_NODES_PACKING ? UNKNOWN_PACKING : DOESNT_FIT_PACKING;
+}
@@ -0,0 +1,38 @@
+/*
+  packing.h
+  Solver that decides if a fleet (number of pieces per type) fits in a map and, if it does, finds one packing of it.
+
+  The search is the one of an exact cover, with the empty cells allowed:
+  the first cell not decided yet (in the order of the rows) is either the first cell of some piece, or is left empty.
+  Since all the pieces take 5 cells, the map only has room for size * size - 5 * (number of pieces) empty cells,
+  and the search backtracks as soon as it needs more. The cells taken are kept in the rows of the engine of placements (placement.h),
+  so each piece is tested on the map, row by row, at once.
+  The search has a limit of cells decided, so fleets that would take too long (like maps fully tiled) are answered as unknown, instead of hanging.
+*/
+
+#ifndef PACKING_H
+#define PACKING_H
+
+#include "piece.h"
+
+// Results of solve_Packing
+typedef enum PackingResult
+{
+    // No packing exists (the whole search was done)
+    DOESNT_FIT_PACKING,
+    // A packing was found
+    FITS_PACKING,
+    // The search reached its limit without finding a packing, so it isn't known
+    UNKNOWN_PACKING
+} PackingResult;
+
+/*
+  Decides if the pieces of 'nr_per_piece' (number of pieces per type, in the order of getType_Utils) fit in a map of size * size.
+  Returns FITS_PACKING if a packing was found, DOESNT_FIT_PACKING if it was proven that there's none,
+  and UNKNOWN_PACKING if the limit of the search was reached before any of those.
+  If they fit and 'pieces' isn't NULL, the pieces of the packing found are written (with update_Piece) on 'pieces',
+  which must have room for all the pieces of the fleet.
+*/
+PackingResult solve_Packing(int size, int nr_per_piece[5], Piece* pieces);
+
+#endif
@@ -1,21 +1,17 @@
- #include "piece.h"
+#include "piece.h"
 
-#include <stdlib.h>
 #include "utils.h"
-#include "io.h"
 
-Piece* new_Piece()
+/*
+  Since the (x,y) is relative to the map, with (posX, posY) being the center of the piece, the (x,y) is the position (x - (p->posX - 2),  y - (p->posY - 2)) in the bitmap.
+  Returns the mask with only the bit of that position set, or 0 if the position is outside of the bitmap.
+*/
+static uint32_t positionBit(Piece* p, int x, int y)
 {
-    Piece* piece = (Piece*) malloc(sizeof(Piece));
-
-    // Case malloc failed, print that malloc failed and abort execution 
-    if(piece == NULL)
-        prompt_IO(ERROR_IO, "piece.c, new_Piece(): malloc failed");
-    
-    // Alloc the bitmap of the piece
-    piece->bitmap = new_BitMap();
-
-    return piece;
+    int bx = x - (p->posX - 2), by = y - (p->posY - 2);
+    if(bx < 0 || bx > 4 || by < 0 || by > 4)
+        return 0;
+    return (uint32_t) 1 << (bx * 5 + by);
 }
 
 void update_Piece(Piece* piece, char type, int posX, int posY, int n)
@@ -27,30 +23,29 @@ void update_Piece(Piece* piece, char type, int posX, int posY, int n)
     piece->posX = posX;
     piece->posY = posY;
 
-    // Update the bitmap
-    update_BitMap(piece->bitmap, type, n);
+    // Update the format, from the table of formats, without hits
+    piece->shape = getMask_BitMap(type, n);
+    piece->hits = 0;
 }
 
 void registerAttack_Piece(Piece* p, int x, int y)
 {
-    // Since the (x,y) is relative to the map, with (posX, posY) being the center of the piece, the (x,y) is the position (x - (p->posX - 2),  y - (p->posY - 2)) in the bitmap.
-    setValue_BitMap(p->bitmap, x - (p->posX - 2), y - (p->posY - 2), 2);
+    p->hits |= positionBit(p, x, y) & p->shape;
 }
 
 byte getStatus_Piece(Piece* p, int x, int y)
 {
-    // Since the (x,y) is relative to the map, with (posX, posY) being the center of the piece, the (x,y) is the position (x - (p->posX - 2),  y - (p->posY - 2)) in the bitmap.
-    return getValue_BitMap(p->bitmap, x - (p->posX - 2), y - (p->posY - 2));
+    uint32_t bit = positionBit(p, x, y);
+    if(!(p->shape & bit)) return 0;
+    return (p->hits & bit) ? 2 : 1;
 }
 
-char getType_Piece(Piece* piece)
+bool isSunk_Piece(Piece* p)
 {
-    return piece->type;
+    return p->hits == p->shape;
 }
 
-void free_Piece(Piece* piece) 
+char getType_Piece(Piece* piece)
 {
-    free_BitMap(piece->bitmap);
-    free(piece);
+    return piece->type;
 }
- 
\ No newline at end of file
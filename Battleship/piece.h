@@ -3,14 +3,16 @@
   Representation of a piece.
 
   The piece has a type, 
-  the bitmap itself, to represent the state and
-  it's position in the map (posX, posY), corresponding to the center of the bitmap on the map, 
+  two masks of 25 bits, to represent the state: the format of the piece and the positions already hitted, and
+  it's position in the map (posX, posY), corresponding to the center of the bitmap on the map.
+  The bit x * 5 + y of the masks corresponds to the position (x,y) of the bitmap 5x5 of the piece (see bitmap.h).
 */
 
 #ifndef PIECE_H
 #define PIECE_H
 
 #include "bitmap.h"
+#include "utils.h"
 
 typedef struct Piece 
 {
@@ -20,14 +22,13 @@ typedef struct Piece
     // Where's the center of the bitmap lies in the map.
     int posX, posY;
 
-    // Bitmap 
-    BitMap* bitmap;
+    // Positions of the bitmap that are part of the piece
+    uint32_t shape;
+    // Positions of the bitmap that are part of the piece and were hitted
+    uint32_t hits;
 } Piece;
 
-// Alloc, dynamically, a new piece
-Piece* new_Piece();
-
-// Updates all the fields of the piece
+// Updates all the fields of the piece (the piece is left without hits)
 void update_Piece(Piece* piece, char type, int posX, int posY, int rotation);
 
 /*
@@ -38,14 +39,15 @@ void registerAttack_Piece(Piece* p, int x, int y);
 
 /*
   Get the status of the piece, that is, if it's hitted or not.
-  Note: (x,y)'s are relative to the map and can go from (posX - 2, posY - 2) to (posX + 2, posY + 2), inclusive, with (posX, posY) being the center of the bitmap
+  Returns 0 if the position isn't part of the piece, 1 if it's part of the piece and isn't hitted and 2 if it's part of the piece and is hitted.
+  Note: (x,y)'s are relative to the map. Outside of (posX - 2, posY - 2) to (posX + 2, posY + 2), inclusive, with (posX, posY) being the center of the bitmap, it's always 0.
 */
 byte getStatus_Piece(Piece* p, int x, int y);
 
+// Returns true if all the positions of the piece were hitted, false otherwise.
+bool isSunk_Piece(Piece* p);
+
 // Returns the type of the piece, that is, 'I', 'P', 'T', 'X' or 'Z'.
 char getType_Piece(Piece* piece);
 
-// Deallocs the piece, including all resources allocated by the piece
-void free_Piece(Piece* p);
-
 #endif
@@ -0,0 +1,189 @@
+#include "placement.h"
+
+#include "utils.h"
+#include "io.h"
+#include <stdlib.h>
+
+// Computes the orientation of the format of 'mask' (see getMask_BitMap), with the rotation 'degree'
+static void initOrientation(Orientation* orientation, uint32_t mask, int degree)
+{
+    int first_row = 5, last_row = -1, first_column = 5, last_column = -1;
+    for(int i = 0; i < 5; i++)
+        for(int j = 0; j < 5; j++)
+            if((mask >> (5 * i + j)) & 1) {
+                if(i < first_row) first_row = i;
+                if(i > last_row) last_row = i;
+                if(j < first_column) first_column = j;
+                if(j > last_column) last_column = j;
+            }
+
+    orientation->degree = degree;
+    orientation->height = last_row - first_row + 1;
+    orientation->width = last_column - first_column + 1;
+    orientation->center_x = 2 - first_row;
+    orientation->center_y = 2 - first_column;
+    for(int i = 0; i < 5; i++)
+        orientation->rows[i] = (i < orientation->height) ? ((mask >> (5 * (first_row + i))) & 31) >> first_column : 0;
+}
+
+// Returns true if both orientations have the same format
+static bool sameFormat(Orientation* a, Orientation* b)
+{
+    if(a->height != b->height || a->width != b->width)
+        return false;
+    for(int i = 0; i < a->height; i++)
+        if(a->rows[i] != b->rows[i])
+            return false;
+    return true;
+}
+
+Placement* new_Placement(int size)
+{
+    // Case the map doesn't fit in the rows of the engine, notify and abort execution
+    if(size <= 0 || size > MAX_SIZE_PLACEMENT)
+        prompt_IO(ERROR_IO, "placement.c, new_Placement(): invalid map size");
+
+    Placement* placement = (Placement*) malloc(sizeof(Placement));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(placement == NULL)
+        prompt_IO(ERROR_IO, "placement.c, new_Placement(): malloc failed");
+
+    placement->size = size;
+    for(int x = 0; x < size; x++)
+        placement->taken[x] = 0;
+
+    // The orientations of each type, without the repeated formats
+    for(int type = 0; type < 5; type++) {
+        placement->nr_orientations[type] = 0;
+        for(int degree = 0; degree < 360; degree += 90) {
+            Orientation* orientation = &placement->orientations[type][placement->nr_orientations[type]];
+            initOrientation(orientation, getMask_BitMap(getType_Utils(type), degree), degree);
+
+            bool repeated = false;
+            for(int k = 0; k < placement->nr_orientations[type] && !repeated; k++)
+                repeated = sameFormat(&placement->orientations[type][k], orientation);
+            if(!repeated)
+                placement->nr_orientations[type]++;
+        }
+    }
+
+    return placement;
+}
+
+bool fits_Placement(Placement* placement, Orientation* orientation, int x, int y)
+{
+    // Outside the map
+    if(x < 0 || y < 0 || x + orientation->height > placement->size || y + orientation->width > placement->size)
+        return false;
+
+    // Some cell already taken
+    for(int i = 0; i < orientation->height; i++)
+        if(placement->taken[x + i] & (orientation->rows[i] << y))
+            return false;
+
+    return true;
+}
+
+void take_Placement(Placement* placement, Orientation* orientation, int x, int y)
+{
+    for(int i = 0; i < orientation->height; i++)
+        placement->taken[x + i] |= orientation->rows[i] << y;
+}
+
+void release_Placement(Placement* placement, Orientation* orientation, int x, int y)
+{
+    for(int i = 0; i < orientation->height; i++)
+        placement->taken[x + i] &= ~(orientation->rows[i] << y);
+}
+
+void takePiece_Placement(Placement* placement, Piece* piece)
+{
+    for(int x = piece->posX - 2; x <= piece->posX + 2; x++)
+        for(int y = piece->posY - 2; y <= piece->posY + 2; y++)
+            if(getStatus_Piece(piece, x, y) != 0)
+                placement->taken[x] |= (uint64_t) 1 << y;
+}
+
+uint64_t anchors_Placement(Placement* placement, Orientation* orientation, int x)
+{
+    // Rows of the piece outside the map
+    if(x < 0 || x + orientation->height > placement->size)
+        return 0;
+
+    // Columns where the rectangle of the orientation is inside the map (size - width + 1 of them, at most 64)
+    int nr_columns = placement->size - orientation->width + 1;
+    uint64_t inside = nr_columns >= 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << nr_columns) - 1;
+
+    // The placement on column y is blocked if the cell (i,j) of the piece is on a cell taken, ie, the bit y of taken[x + i] >> j is set
+    uint64_t blocked = 0;
+    for(int i = 0; i < orientation->height; i++)
+        for(int j = 0; j < orientation->width; j++)
+            if((orientation->rows[i] >> j) & 1)
+                blocked |= placement->taken[x + i] >> j;
+
+    return inside & ~blocked;
+}
+
+// Returns the number of bits set of the row
+static int countBits(uint64_t row)
+{
+    return __builtin_popcountll(row);
+}
+
+/*
+    Goes through the legal placements of a type of piece, in order (orientation, then row, then column), and returns how many there are.
+    If 'chosen' isn't negative, stops on the legal placement number 'chosen' (starting on 0),
+    writing it on *p_orientation, *p_x and *p_y.
+    The placements are counted a whole row of anchors at a time (see anchors_Placement).
+*/
+static int scan(Placement* placement, int type, int chosen, Orientation** p_orientation, int* p_x, int* p_y)
+{
+    int count = 0;
+    for(int k = 0; k < placement->nr_orientations[type]; k++) {
+        Orientation* orientation = &placement->orientations[type][k];
+        for(int x = 0; x + orientation->height <= placement->size; x++) {
+            uint64_t anchors = anchors_Placement(placement, orientation, x);
+            int nr_anchors = countBits(anchors);
+            if(chosen < 0 || count + nr_anchors <= chosen) {
+                count += nr_anchors;
+                continue;
+            }
+
+            // The chosen placement is on this row: drop the anchors before it, lowest column first
+            for(int skip = chosen - count; skip > 0; skip--)
+                anchors &= anchors - 1;
+            *p_orientation = orientation;
+            *p_x = x;
+            *p_y = __builtin_ctzll(anchors);
+            return chosen;
+        }
+    }
+    return count;
+}
+
+int count_Placement(Placement* placement, int type)
+{
+    return scan(placement, type, -1, NULL, NULL, NULL);
+}
+
+bool random_Placement(Placement* placement, int type, Piece* piece, Random* random)
+{
+    // First count the legal placements, then go to the one chosen
+    int count = count_Placement(placement, type);
+    if(count == 0)
+        return false;
+
+    // Set by scan, since the placement chosen is below the count (initialized only so the optimized builds don't warn)
+    Orientation* orientation = NULL;
+    int x = 0, y = 0;
+    scan(placement, type, range_Random(random, count), &orientation, &x, &y);
+
+    take_Placement(placement, orientation, x, y);
+    update_Piece(piece, getType_Utils(type), x + orientation->center_x, y + orientation->center_y, orientation->degree);
+    return true;
+}
+
+void free_Placement(Placement* placement)
+{
+    free(placement);
+}
@@ -0,0 +1,89 @@
+/*
+  placement.h
+  Engine of the legal placements of the pieces on a map.
+
+  The engine keeps the cells of the map already taken by pieces, one 64-bit row per row of the map (so the map has, at most, 64 columns).
+  A placement is one orientation of a type of piece, with the top-left corner of the square around the orientation at some cell (x,y) of the map.
+  It's legal if the piece lies inside the map and doesn't take a cell already taken.
+  The legal placements aren't stored: they're counted (and chosen) on demand, a whole row of the map at once,
+  shifting the rows taken by each cell of the piece (so the 64 columns are tested with a few operations on words).
+*/
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include "piece.h"
+#include "random.h"
+#include <stdint.h>
+
+// Max size of the maps handled by the engine (one 64-bit word per row)
+#define MAX_SIZE_PLACEMENT 64
+
+/*
+  Definition of an orientation of a type of piece, that is, its format with one of the rotations.
+  Rotations with the same format (e.g. the piece X on all the rotations) give only one orientation, so no placement is counted twice.
+*/
+typedef struct Orientation
+{
+    // Degree of the rotation (0, 90, 180 or 270) of the format
+    int degree;
+
+    // Number of rows and columns of the smallest rectangle around the format
+    int height, width;
+
+    // Position of the center of the bitmap, relative to the top-left corner of the rectangle
+    int center_x, center_y;
+
+    // Rows of the format, inside the rectangle, with the bit j of the row i corresponding to the cell (i,j) of the rectangle
+    uint64_t rows[5];
+} Orientation;
+
+// Definition of the engine
+typedef struct Placement
+{
+    // Size of the map
+    int size;
+
+    // Cells taken, with the bit y of the row x corresponding to the cell (x,y)
+    uint64_t taken[MAX_SIZE_PLACEMENT];
+
+    // Orientations of each type of piece (in the order of getType_Utils)
+    Orientation orientations[5][4];
+    int nr_orientations[5];
+} Placement;
+
+// Allocs a new engine for a map of size * size, without cells taken
+Placement* new_Placement(int size);
+
+// Returns true if the orientation fits on the map with the top-left corner of its rectangle on (x,y), otherwise returns false
+bool fits_Placement(Placement* placement, Orientation* orientation, int x, int y);
+
+/*
+  Returns the legal placements of the orientation with the top-left corner of its rectangle on the row x, all at once:
+  the bit y is set if the orientation fits with the corner on (x,y) (as in fits_Placement).
+*/
+uint64_t anchors_Placement(Placement* placement, Orientation* orientation, int x);
+
+// Marks as taken the cells of the orientation, with the top-left corner of its rectangle on (x,y)
+void take_Placement(Placement* placement, Orientation* orientation, int x, int y);
+
+// Marks as free (not taken) the cells of the orientation, with the top-left corner of its rectangle on (x,y)
+void release_Placement(Placement* placement, Orientation* orientation, int x, int y);
+
+// Marks as taken the cells of a piece already on the map (it must be inside the map)
+void takePiece_Placement(Placement* placement, Piece* piece);
+
+// Returns the number of legal placements of the type of piece 'type' (0 to 4, as in getType_Utils)
+int count_Placement(Placement* placement, int type);
+
+/*
+  Chooses, uniformly (with the generator 'random'), one of the legal placements of the type of piece 'type' (0 to 4, as in getType_Utils),
+  updates the piece to be there, with update_Piece, and marks its cells as taken.
+  If there's no legal placement, returns false and nothing changes. Otherwise returns true.
+*/
+bool random_Placement(Placement* placement, int type, Piece* piece, Random* random);
+
+// Frees the engine
+void free_Placement(Placement* placement);
+
+#endif
@@ -12,21 +12,45 @@ Player* new_Player(int map_size) {
 
     // Set the hp of the player to 0
     player->hp = 0;
+
+    // Alloc the array of pieces. Each piece takes 5 cells, so there's never more than map_size * map_size / 5 pieces on the map.
+    player->max_pieces = map_size * map_size / 5;
+    if(player->max_pieces > MAX_PIECES_CELL)
+        player->max_pieces = MAX_PIECES_CELL;
+    player->nr_pieces = 0;
+    player->pieces = (Piece*) malloc((player->max_pieces > 0 ? player->max_pieces : 1) * sizeof(Piece));
+
+    // Case malloc failed, print that malloc failed and abort execution 
+    if(player->pieces == NULL)
+        prompt_IO(ERROR_IO, "player.c, new_Player(): malloc of the pieces failed");
+
     // And alloc his map
-    player->map = new_Map(map_size);
+    player->map = new_Map(map_size, player->pieces);
 
     return player;
 }
 
+Piece* nextPiece_Player(Player* player)
+{
+    // Case there's no room for more pieces, notify and abort execution
+    if(player->nr_pieces == player->max_pieces)
+        prompt_IO(ERROR_IO, "player.c, nextPiece_Player(): no room for more pieces");
+
+    return &player->pieces[player->nr_pieces];
+}
+
 int addPiece_Player(Player* player, Piece* piece)
 {
     // (Tries to) add a piece to the map
     int resultAddPiece = addPiece_Map(player->map, piece);
     
     // If the result is 0, than that means that the piece was added
-    if(resultAddPiece == 0)
+    if(resultAddPiece == 0) {
         //So if was added, increase the hp by 5 (every piece is "size" 5)
         player->hp += 5;
+        // and the piece is now taken on the array
+        player->nr_pieces++;
+    }
     return resultAddPiece;
 }
 
@@ -47,8 +71,9 @@ char getPieceType_Player(Player* player, int x, int y)
 
 int registerAttack_Player(Player* player, int x, int y)
 {
-   // Register the attack on the map
-   int result = registerAttack_Map(player->map, x, y);
+   // Register the attack on the map, with one lookup of the cell
+   CellHandle cell = findCell_Map(player->map, x, y);
+   int result = registerAttackCell_Map(&cell);
 
    // If the attack result is between 1 and 5, inclusive, then some piece was hitted sucessfully, so we can decrease the hp of the player by 1.
    if(result >= 1 && result <= 5) player->hp -= 1;
@@ -58,35 +83,20 @@ int registerAttack_Player(Player* player, int x, int y)
 
 void registerShot_Player(Player* player, int x, int y, int attack_result)
 {
-    switch(attack_result) {
-        // Attack went outside the map. Nothing to register.
-        case -1: break;
-        
-        // Missed attack. 
-        case 0: registerShot_Map(player->map, x, y, 1); break;
-        
-        // Attack on piece I with sucess
-        case 1: registerShot_Map(player->map, x, y, 2); break;
-
-        // Attack on piece P with sucess        
-        case 2: registerShot_Map(player->map, x, y, 3); break;
-
-        // Attack on piece T with sucess
-        case 3: registerShot_Map(player->map, x, y, 4); break;
-
-        // Attack on piece X with sucess
-        case 4: registerShot_Map(player->map, x, y, 5); break;
-
-        // Attack on piece Z with sucess
-        case 5: registerShot_Map(player->map, x, y, 6); break;
-
-        // Attack on piece already hitted. Nothing to register.
-        case 6: break;
-    }
+    // Missed attack (0) is registered as 1, and the attacks on the pieces I, P, T, X and Z with sucess (1 to 5) as 2 to 6.
+    // The attacks outside the map (-1) and on pieces already hitted (6) aren't registered.
+    if(attack_result < 0 || attack_result > 5)
+        return;
+
+    // The cell is inserted, if it isn't on the map yet, and marked, with one lookup
+    CellHandle cell = findOrInsertCell_Map(player->map, x, y);
+    registerShotCell_Map(&cell, attack_result + 1);
 }
 
 void free_Player(Player* player) 
 {
     free_Map(player->map);
+    // The map doesn't free the pieces, they're all freed at once
+    free(player->pieces);
     free(player);
 }
\ No newline at end of file
@@ -2,8 +2,9 @@
   player.h
   Representation of a player.
 
-  The piece has a hp and a map.
+  The piece has a hp, a map and the pieces added to the map.
   The hp corresponds to the number of (x,y) coordinates in the map that have a piece not destroyed.
+  The pieces are all in one array, owned by the player, and the cells of the map refer to them by their position in it.
 */
 
 #ifndef PLAYER_H
@@ -16,13 +17,23 @@ typedef struct Player
 {
     int hp;
     Map* map;
+
+    // Array of the pieces, with room for all the pieces that can fit in the map, and the number of pieces already added
+    Piece* pieces;
+    int nr_pieces, max_pieces;
 } Player;
 
-// Alocs a new player and his map of map_size * map_size. Also, his hp is setted to 0.
+// Alocs a new player, his map of map_size * map_size and his array of pieces. Also, his hp is setted to 0.
 Player* new_Player(int map_size);
 
 /*
-    Tries to add a piece to the map of the player.
+    Returns the next free piece of the array of pieces of the player, to be updated (with update_Piece) and added with addPiece_Player.
+    Until it's added, the same piece is returned, so it can be updated again if it can't be added.
+*/
+Piece* nextPiece_Player(Player* player);
+
+/*
+    Tries to add a piece, given by nextPiece_Player, to the map of the player.
     If the piece can be added, the piece is added, the hp increases by 5 (all pieces have "size" of 5) and the function returns 'true'.
     Otherwise, the piece isn't added, and the function returns 'false'.
 */
@@ -0,0 +1,62 @@
+#include "pool.h"
+
+#include <stdlib.h>
+#include "io.h"
+
+// Alignment of the memory given by the pool
+#define ALIGNMENT 8
+
+// Allocs a new slab with 'capacity' bytes of data, on top of the slab 'next'
+static Slab* new_Slab(size_t capacity, Slab* next)
+{
+    Slab* slab = (Slab*) malloc(sizeof(Slab) + capacity);
+    // Case malloc failed, print that malloc failed and abort execution
+    if(slab == NULL)
+        prompt_IO(ERROR_IO, "pool.c, new_Slab(): malloc failed");
+
+    slab->next = next;
+    slab->used = 0;
+    slab->capacity = capacity;
+
+    return slab;
+}
+
+Pool* new_Pool(size_t size)
+{
+    Pool* pool = (Pool*) malloc(sizeof(Pool));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(pool == NULL)
+        prompt_IO(ERROR_IO, "pool.c, new_Pool(): malloc failed");
+
+    pool->slab = new_Slab(size, NULL);
+
+    return pool;
+}
+
+void* alloc_Pool(Pool* pool, size_t size)
+{
+    // Round the size up, so the next allocation stays aligned
+    size = (size + ALIGNMENT - 1) & ~(size_t) (ALIGNMENT - 1);
+
+    // Case the slab in use is full, a new one (twice as big, or enough for 'size') is put on top of it
+    if(pool->slab->used + size > pool->slab->capacity) {
+        size_t capacity = 2 * pool->slab->capacity;
+        if(capacity < size) capacity = size;
+        pool->slab = new_Slab(capacity, pool->slab);
+    }
+
+    void* memory = pool->slab->data + pool->slab->used;
+    pool->slab->used += size;
+    return memory;
+}
+
+void free_Pool(Pool* pool)
+{
+    // Since the slabs double in size, there are only a few of them to free
+    while(pool->slab != NULL) {
+        Slab* next = pool->slab->next;
+        free(pool->slab);
+        pool->slab = next;
+    }
+    free(pool);
+}
@@ -0,0 +1,41 @@
+/*
+  pool.h
+  Representation of a pool (arena) of memory.
+
+  The memory is taken from big blocks (slabs), each one twice the size of the previous one, and it's only given back all at once, when the pool is freed.
+  It's used for lots of small allocations that live as long as the structure that owns the pool (for example, the nodes of a quadtree and its cells).
+*/
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+// Definition of a slab
+typedef struct Slab
+{
+  // Previous slab of the pool
+  struct Slab* next;
+  // Bytes of data in use and available
+  size_t used, capacity;
+  // The data itself
+  char data[];
+} Slab;
+
+// Definition of the pool
+typedef struct Pool
+{
+  // Slab in use (the last one allocated)
+  Slab* slab;
+} Pool;
+
+// Allocs a new pool, with a first slab of, at least, 'size' bytes.
+Pool* new_Pool(size_t size);
+
+// Returns 'size' bytes from the pool, aligned to 8 bytes. The memory isn't initialized.
+void* alloc_Pool(Pool* pool, size_t size);
+
+// Frees the pool and all the memory taken from it.
+void free_Pool(Pool* pool);
+
+#endif
@@ -1,22 +1,22 @@
 #include "quadtree.h"
 
-#include "io.h"
 #include "utils.h"
-#include <stdlib.h>
 
-// Check is a point is inside the boundaries of a square, define by the coordinates that limit the quadtree qt.
-static bool inside(QuadTree* qt, Point* p) 
-{ 
-    if(p->x >= qt->topLeft.x && p->x <= qt->botRight.x && p->y >= qt->topLeft.y && p->y <= qt->botRight.y)
-        return true;
-    return false;
-} 
+// Returns the quadrant, of a quadtree of level 'shift + 1', where the point (x,y) lies.
+static int quadrant(int x, int y, int shift)
+{
+    return ((x >> shift) & 1) | (((y >> shift) & 1) << 1);
+}
+
+// Check is a point is inside the boundaries of the (root) quadtree qt.
+static bool inside(QuadTree* qt, int x, int y)
+{
+    return x >= 0 && y >= 0 && (x >> qt->level) == 0 && (y >> qt->level) == 0;
+}
 
-// Allocs a new quadnode.
-static QuadNode* new_QuadNode(Cell* cell, int x, int y) {
-    QuadNode* newNode = (QuadNode*) malloc(sizeof(QuadNode));
-    if(newNode == NULL)
-        prompt_IO(ERROR_IO, "quadtree.c, new_QuadNode(): malloc failed");
+// Allocs a new quadnode from the pool.
+static QuadNode* new_QuadNode(Pool* pool, Cell* cell, int x, int y) {
+    QuadNode* newNode = (QuadNode*) alloc_Pool(pool, sizeof(QuadNode));
 
     newNode->cell = cell;
     set_Point(&newNode->p, x, y);
@@ -24,184 +24,102 @@ static QuadNode* new_QuadNode(Cell* cell, int x, int y) {
     return newNode;
 }
 
-// Alocs a new quadtree with boundaries defined by the upper corner (x1,y1) and bottom corner (x2,y2).
-QuadTree* newAux(int x1, int y1, int x2, int y2)
+// Alocs a new quadtree from the pool, covering a square of side 2^level.
+static QuadTree* newAux(Pool* pool, int level)
 {
-    QuadTree* qt = (QuadTree*) malloc(sizeof(QuadTree));
-    if(qt == NULL)
-        prompt_IO(ERROR_IO, "quadtree.c, newAux(): malloc failed");
+    QuadTree* qt = (QuadTree*) alloc_Pool(pool, sizeof(QuadTree));
 
+    qt->pool = pool;
+    qt->level = level;
     qt->n = NULL;
     for(int i = 0; i < 4; i++)
         qt->quadrants[i] = NULL;
     
-    set_Point(&qt->topLeft, x1, y1);
-    set_Point(&qt->botRight, x2, y2);
-    
     return qt;
 }
 
-// Allocs a new quadtree with boundaries defined by the upper corner (0,0) and bottom corner (size,size).
-QuadTree* new_QuadTree(int size)
+// Allocs a new quadtree covering the smallest square of side 2^level, with upper corner (0,0), where the map fits.
+QuadTree* new_QuadTree(int size, Pool* pool)
 {
-    QuadTree* qt = (QuadTree*) malloc(sizeof(QuadTree));
-    if(qt == NULL)
-        prompt_IO(ERROR_IO, "quadtree.c, new_QuadTree(): malloc failed");
-
-    qt->n = NULL;
-    for(int i = 0; i < 4; i++)
-        qt->quadrants[i] = NULL;
-    
-    set_Point(&qt->topLeft, 0, 0);
-    set_Point(&qt->botRight, size, size);
-    
-    return qt;
+    int level = 0;
+    while((1 << level) < size)
+        level++;
+    return newAux(pool, level);
 }
 
-static void insertAux(QuadTree* qt, QuadNode* qn) 
+QuadNode* insertNode_QuadTree(QuadTree* qt, int x, int y)
 {
     // Check if it's inside the boundaries
-    if(!inside(qt, &qn->p))
-        return;
-    
-    // Reached a unit quad
-    if(abs(qt->topLeft.x - qt->botRight.x) <= 1 && abs(qt->topLeft.y - qt->botRight.y) <= 1) {
-        if(qt->n == NULL)
-            qt->n = qn;
-        return;
+    if(!inside(qt, x, y))
+        return NULL;
+
+    // Go down till the unit quad, creating the quadrants missing in the way
+    while(qt->level > 0) {
+        int q = quadrant(x, y, qt->level - 1);
+        if(qt->quadrants[q] == NULL)
+            qt->quadrants[q] = newAux(qt->pool, qt->level - 1);
+        qt = qt->quadrants[q];
     }
 
-    // Choose the appropriate subtree to add.
-    // L
-    if ((qt->topLeft.x + qt->botRight.x) / 2 >= qn->p.x) 
-    { 
-        // TL 
-        if ((qt->topLeft.y + qt->botRight.y) / 2 >= qn->p.y) 
-        { 
-            if (qt->quadrants[0] == NULL)
-                qt->quadrants[0] = newAux(qt->topLeft.x, qt->topLeft.y, (qt->topLeft.x + qt->botRight.x) / 2, (qt->topLeft.y + qt->botRight.y) / 2);
-            insertAux(qt->quadrants[0], qn); 
-        } 
-        // BL 
-        else
-        { 
-            if (qt->quadrants[2] == NULL)
-                qt->quadrants[2] = newAux(qt->topLeft.x, (qt->topLeft.y + qt->botRight.y) / 2, (qt->topLeft.x + qt->botRight.x) / 2, qt->botRight.y); 
-            insertAux(qt->quadrants[2], qn); 
-        } 
-    } 
-    // R
-    else
-    { 
-        // TR
-        if ((qt->topLeft.y + qt->botRight.y) / 2 >= qn->p.y) 
-        { 
-
-            if (qt->quadrants[1] == NULL)
-                qt->quadrants[1] = newAux((qt->topLeft.x + qt->botRight.x) / 2, qt->topLeft.y, qt->botRight.x, (qt->topLeft.y + qt->botRight.y) / 2); 
-            insertAux(qt->quadrants[1], qn); 
-        } 
-  
-        // BR 
-        else
-        { 
-            if (qt->quadrants[3] == NULL)
-                qt->quadrants[3] = newAux((qt->topLeft.x + qt->botRight.x) / 2, (qt->topLeft.y + qt->botRight.y) / 2, qt->botRight.x, qt->botRight.y); 
-            insertAux(qt->quadrants[3], qn); 
-        } 
-    } 
-}   
-
-void insert_QuadTree(QuadTree* qt, Cell* cell, int x, int y) {
-    QuadNode* qn = new_QuadNode(cell, x, y);
-    insertAux(qt, qn);
+    if(qt->n == NULL)
+        qt->n = new_QuadNode(qt->pool, NULL, x, y);
+    return qt->n;
 }
 
-static void searchAux(QuadTree* qt, Cell** cell_found, Point* p) {
-    // Not in this region
-    if (!inside(qt, p)) 
-        return; 
-  
-    // Unit QuadTree 
-    if (qt->n != NULL) {
-        *cell_found = qt->n->cell;
-        return; 
-    } 
-
-    // L
-    if ((qt->topLeft.x + qt->botRight.x) / 2 >= p->x) 
-    { 
-        // TL
-        if ((qt->topLeft.y + qt->botRight.y) / 2 >= p->y) 
-        { 
-            if (qt->quadrants[0] == NULL) 
-                return; 
-            searchAux(qt->quadrants[0], cell_found, p); 
-        } 
-  
-        // BL 
-        else
-        { 
-            if (qt->quadrants[2] == NULL) 
-                return; 
-            searchAux(qt->quadrants[2], cell_found, p); 
-        } 
-    } 
-    // R
-    else
-    { 
-        // TR 
-        if ((qt->topLeft.y + qt->botRight.y) / 2 >= p->y) 
-        { 
-            if (qt->quadrants[1] == NULL) 
-                return; 
-            searchAux(qt->quadrants[1], cell_found, p); 
-        } 
-  
-        // BR 
-        else
-        { 
-            if (qt->quadrants[3] == NULL) 
-                return; 
-            searchAux(qt->quadrants[3], cell_found, p); 
-        } 
-    }  
+void insert_QuadTree(QuadTree* qt, Cell* cell, int x, int y) 
+{
+    QuadNode* node = insertNode_QuadTree(qt, x, y);
+    if(node != NULL && node->cell == NULL)
+        node->cell = cell;
 }
 
-void search_QuadTree(QuadTree* qt, Cell** cell_found, int x, int y) 
+Cell* search_QuadTree(QuadTree* qt, int x, int y) 
 {
-    Point* p = new_Point(x, y);
-    searchAux(qt, cell_found, p);
-    free_Point(p);
+    // Not in this region
+    if(!inside(qt, x, y))
+        return NULL;
+
+    // Go down, one level per bit, till the unit quad
+    while(qt->level > 0) {
+        qt = qt->quadrants[quadrant(x, y, qt->level - 1)];
+        if(qt == NULL)
+            return NULL;
+    }
+
+    // Unit quad
+    return qt->n->cell;
 }
 
 bool hasCell_QuadTree(QuadTree* qt, int x, int y)
 {
-    // Search for the cell on position (x,y).
-    Cell* cell_found = NULL;
-    search_QuadTree(qt, &cell_found, x, y);
-    
-    if(cell_found != NULL) return true;
-    return false;
+    return search_QuadTree(qt, x, y) != NULL;
 }
 
-// Frees a quadnode and all the memory allocated in it.
-void free_QuadNode(QuadNode* qn)
+/*
+  Visits the cells of the quadtree qt, with upper corner (ox,oy), inside the rectangle (x1,y1) (x2,y2).
+  Returns false if the visitor asked to stop.
+*/
+static bool visitAux(QuadTree* qt, int ox, int oy, int x1, int y1, int x2, int y2, CellVisitor visitor, void* context)
 {
-    if(qn != NULL) {
-        if(qn->cell != NULL)
-            free_Cell(qn->cell);
-        free(qn);
-    }
+    int side = 1 << qt->level;
+
+    // Not in this region
+    if(ox > x2 || oy > y2 || ox + side - 1 < x1 || oy + side - 1 < y1)
+        return true;
+
+    // Unit quad
+    if(qt->level == 0)
+        return visitor(qt->n->cell, ox, oy, context);
+
+    // The quadrant q has the upper corner moved by half of the side, on x, if the bit 0 of q is set and, on y, if the bit 1 is set.
+    int half = side / 2;
+    for(int q = 0; q < 4; q++)
+        if(qt->quadrants[q] != NULL && !visitAux(qt->quadrants[q], ox + (q & 1) * half, oy + (q >> 1) * half, x1, y1, x2, y2, visitor, context))
+            return false;
+    return true;
 }
 
-void free_QuadTree(QuadTree* qt)
+void visit_QuadTree(QuadTree* qt, int x1, int y1, int x2, int y2, CellVisitor visitor, void* context)
 {
-    if(qt != NULL) {
-        free_QuadNode(qt->n);
-        for(int i = 0; i < 4; i++)
-            free_QuadTree(qt->quadrants[i]);
-        free(qt); 
-    }
+    visitAux(qt, 0, 0, x1, y1, x2, y2, visitor, context);
 }
-
@@ -2,8 +2,8 @@
 #define QUADTREE_H
 
 #include "cell.h"
-#include "quadtree.h"
 #include "point.h"
+#include "pool.h"
 
 typedef struct QuadNode {
   // (x,y)
@@ -12,33 +12,56 @@ typedef struct QuadNode {
   Cell* cell;
 } QuadNode;
 
+/*
+  The quadtree covers a square of side 2^level, with the upper corner on a multiple of 2^level.
+  Each quadrant covers the square of side 2^(level - 1) given by the bit (level - 1) of the coordinates (x,y),
+  so the way down to a point (x,y) is read directly from the bits of x and y, from the most significant to the less significant.
+  The quadtrees of level 0 (unit quads) are the only ones with nodes.
+*/
 typedef struct QuadTree {
-  // Limits
-  Point topLeft;
-  Point botRight;
+  // The quadtree covers a square of side 2^level
+  int level;
 
   // Node
   QuadNode* n;
 
   // Subtrees/Quadrants (TL (topleft), TR (topright), BL (botleft), BR(botright), respectively).
+  // The quadrant of (x,y) is the index: (bit (level - 1) of x) + 2 * (bit (level - 1) of y).
   struct QuadTree* quadrants[4];
+
+  // Pool where the quadtree, its subtrees and nodes are allocated
+  Pool* pool;
 } QuadTree;
 
-// Allocs a new quadtree.
-QuadTree* new_QuadTree(int size);
+// Allocs a new quadtree, able to hold the points from (0,0) to (size - 1, size - 1), taking all its memory from the pool.
+QuadTree* new_QuadTree(int size, Pool* pool);
 
 // Insert a node in the quadtree representing the position (x,y) with a Cell cell.
+// If the position (x,y) already has a node, or is outside the quadtree, nothing happens.
 void insert_QuadTree(QuadTree* qt, Cell* cell, int x, int y);
 
-// Search the quadtree for the point (x,y). If found, set *cell_found to the cell of the node. 
-// That is, we can give this function a pointer, and this function makes the pointer point to the cell in position (x,y). 
-void search_QuadTree(QuadTree* qt, Cell** cell_found, int x, int y);
+// Returns the node representing the position (x,y), inserting one, with a NULL cell, if there's none, on the same descent as the search.
+// The caller sets the cell of a new node before anything else reads the quadtree. If (x,y) is outside the quadtree, returns NULL.
+QuadNode* insertNode_QuadTree(QuadTree* qt, int x, int y);
+
+// Search the quadtree for the point (x,y). If found, returns the cell of the node, otherwise returns NULL.
+// The search doesn't alloc any memory and it's done without recursion, descending one level per bit of the coordinates.
+Cell* search_QuadTree(QuadTree* qt, int x, int y);
 
 // Returns true if exists a node, representing the point (x,y),
 // and has a Cell ('cell' not null), in it. Otherwise, returns false.
 bool hasCell_QuadTree(QuadTree* qt, int x, int y);
 
-// Frees the quadtree and all the memory allocated in it.
-void free_QuadTree(QuadTree* qt);
+/*
+  Calls the visitor for each cell in the rectangle with upper corner (x1,y1) and bottom corner (x2,y2), inclusive,
+  till there are no more cells or the visitor returns false.
+  It's one traversal of the quadtree, that only goes down the quadrants that exist and intersect the rectangle.
+*/
+void visit_QuadTree(QuadTree* qt, int x1, int y1, int x2, int y2, CellVisitor visitor, void* context);
+
+/*
+  There's no function to free the quadtree: all its memory lives in the pool given to new_QuadTree,
+  so it's all given back, at once, when the pool is freed.
+*/
 
 #endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "random.h"
+
+#include "io.h"
+
+// Rotates the bits of x, k positions to the left
+static uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// Generator used to spread the bits of the seed over the state (splitmix64)
+static uint64_t splitmix(uint64_t* x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void seed_Random(Random* random, uint64_t seed)
+{
+    // The state never becomes all 0 this way
+    for(int i = 0; i < 4; i++)
+        random->state[i] = splitmix(&seed);
+}
+
+uint64_t next_Random(Random* random)
+{
+    uint64_t* s = random->state;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+int range_Random(Random* random, int n)
+{
+    // Case the range is empty, notify and abort execution
+    if(n <= 0)
+        prompt_IO(ERROR_IO, "random.c, range_Random(): invalid range");
+
+    /*
+        The 32 high bits of the number, times n, give a number between 0 and n - 1 on the 32 high bits of the product (without a division).
+        The few products whose 32 low bits are below 2^32 % n would make some numbers more likely, so they're thrown away.
+    */
+    uint32_t bound = (uint32_t) n;
+    uint64_t product = (next_Random(random) >> 32) * bound;
+    if((uint32_t) product < bound) {
+        uint32_t threshold = -bound % bound;
+        while((uint32_t) product < threshold)
+            product = (next_Random(random) >> 32) * bound;
+    }
+    return (int) (product >> 32);
+}
+
+void split_Random(Random* random, Random* child)
+{
+    // Polynomial that jumps 2^128 numbers ahead
+    static const uint64_t jump[4] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+
+    *child = *random;
+
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    for(int i = 0; i < 4; i++) {
+        for(int b = 0; b < 64; b++) {
+            if(jump[i] & ((uint64_t) 1 << b))
+                for(int k = 0; k < 4; k++)
+                    s[k] ^= random->state[k];
+            next_Random(random);
+        }
+    }
+    for(int k = 0; k < 4; k++)
+        random->state[k] = s[k];
+}
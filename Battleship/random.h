@@ -0,0 +1,37 @@
+/*
+  random.h
+  Generator of pseudo-random numbers (xoshiro256**).
+
+  Each generator has its own state, so nothing is shared between generators (unlike rand()),
+  and the same seed always gives the same numbers, on any machine.
+  A generator can be split: the new generator is a stream of numbers that doesn't overlap with the stream of the first,
+  so each thread can have its own generator, all coming from one seed.
+*/
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+// Definition of the generator
+typedef struct Random
+{
+    uint64_t state[4];
+} Random;
+
+// Sets the state of the generator from a seed (any value, 0 included)
+void seed_Random(Random* random, uint64_t seed);
+
+// Returns the next 64 random bits
+uint64_t next_Random(Random* random);
+
+// Returns a random int between 0 and n - 1, inclusive, all with the same probability (n must be positive)
+int range_Random(Random* random, int n);
+
+/*
+  Splits the generator: 'child' gets the next 2^128 numbers of 'random', and 'random' jumps after them.
+  So the numbers of both never overlap, and the same generator split the same way always gives the same children.
+*/
+void split_Random(Random* random, Random* child);
+
+#endif
@@ -0,0 +1,265 @@
+// Needed for mmap
+#define _POSIX_C_SOURCE 200112L
+
+#include "record.h"
+
+#include "utils.h"
+#include "io.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Start of a file of records
+static const byte magic[4] = { 'B', 'S', 'R', '1' };
+
+// Zigzag encoding of a difference: n >= 0 is 2n and n < 0 is -2n - 1, so the small differences are small numbers
+static uint64_t zigzag(int64_t n)
+{
+    return n >= 0 ? 2 * (uint64_t) n : 2 * (uint64_t) -(n + 1) + 1;
+}
+
+static int64_t unzigzag(uint64_t u)
+{
+    return (u & 1) ? -(int64_t) (u >> 1) - 1 : (int64_t) (u >> 1);
+}
+
+// Writes 'value' as a varint on 'out' and returns the number of bytes written (at most 10)
+static int encodeVarint(byte* out, uint64_t value)
+{
+    int n = 0;
+    while(value >= 0x80) {
+        out[n++] = (byte) (value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (byte) value;
+    return n;
+}
+
+// Adds a varint to the bytes of the record, growing them if needed
+static void putVarint(Record* record, uint64_t value)
+{
+    if(record->length + 10 > record->capacity) {
+        byte* bytes = (byte*) realloc(record->bytes, 2 * record->capacity);
+        // Case realloc failed, print that realloc failed and abort execution
+        if(bytes == NULL)
+            prompt_IO(ERROR_IO, "record.c, putVarint(): realloc failed");
+        record->bytes = bytes;
+        record->capacity *= 2;
+    }
+    record->length += encodeVarint(record->bytes + record->length, value);
+}
+
+// Returns the rotation (0 to 3, of 90 degrees) of the piece: the first one with its format (the pieces with symmetries have more than one)
+static int rotation(Piece* piece)
+{
+    Piece rotated;
+    for(int r = 0; r < 4; r++) {
+        update_Piece(&rotated, piece->type, piece->posX, piece->posY, 90 * r);
+        if(rotated.shape == piece->shape)
+            return r;
+    }
+
+    prompt_IO(ERROR_IO, "record.c, rotation(): the piece has no rotation");
+    return 0;
+}
+
+Record* new_Record()
+{
+    Record* record = (Record*) malloc(sizeof(Record));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(record == NULL)
+        prompt_IO(ERROR_IO, "record.c, new_Record(): malloc failed");
+
+    // Enough for the setup and the attacks of most of the games
+    record->capacity = 4096;
+    record->bytes = (byte*) malloc(record->capacity);
+    if(record->bytes == NULL)
+        prompt_IO(ERROR_IO, "record.c, new_Record(): malloc failed");
+    record->length = RESERVED_RECORD;
+    return record;
+}
+
+void writeMagic_Record(FILE* file)
+{
+    // Case the write failed, print that the write failed and abort execution
+    if(fwrite(magic, 1, sizeof(magic), file) != sizeof(magic))
+        prompt_IO(ERROR_IO, "record.c, writeMagic_Record(): write failed");
+}
+
+void start_Record(Record* record, Game* game)
+{
+    record->length = RESERVED_RECORD;
+    for(int p = 0; p < 2; p++)
+        record->last_x[p] = record->last_y[p] = 0;
+
+    // Both players have the same setup, so the number of pieces of each type is counted on the player 1
+    Player* first = game->players[0];
+    int nr_per_piece[5] = { 0, 0, 0, 0, 0 };
+    for(int i = 0; i < first->nr_pieces; i++)
+        nr_per_piece[getTypeIndex_Utils(first->pieces[i].type)]++;
+
+    putVarint(record, game->seed);
+    putVarint(record, first->map->size);
+    for(int i = 0; i < 5; i++)
+        putVarint(record, nr_per_piece[i]);
+    putVarint(record, game->player_attacking);
+
+    int last_x = 0, last_y = 0;
+    for(int p = 0; p < 2; p++) {
+        Player* player = game->players[p];
+        for(int i = 0; i < player->nr_pieces; i++) {
+            Piece* piece = &player->pieces[i];
+            putVarint(record, zigzag(piece->posX - last_x) << 2 | rotation(piece));
+            putVarint(record, zigzag(piece->posY - last_y));
+            last_x = piece->posX;
+            last_y = piece->posY;
+        }
+    }
+}
+
+void attack_Record(Record* record, int id_player, int x, int y, int result)
+{
+    putVarint(record, zigzag((int64_t) x - record->last_x[id_player]) << 3 | (result + 1));
+    putVarint(record, zigzag((int64_t) y - record->last_y[id_player]));
+    record->last_x[id_player] = x;
+    record->last_y[id_player] = y;
+}
+
+void write_Record(Record* record, FILE* file)
+{
+    // The length goes right before the bytes of the game, on the room left for it, so it's all one block
+    byte length[10];
+    size_t body = record->length - RESERVED_RECORD;
+    int n = encodeVarint(length, body);
+    byte* start = record->bytes + RESERVED_RECORD - n;
+    memcpy(start, length, n);
+
+    // Case the write failed, print that the write failed and abort execution
+    if(fwrite(start, 1, n + body, file) != n + body)
+        prompt_IO(ERROR_IO, "record.c, write_Record(): write failed");
+}
+
+void free_Record(Record* record)
+{
+    free(record->bytes);
+    free(record);
+}
+
+Replay* open_Replay(const char* path)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat status;
+    if(fd < 0 || fstat(fd, &status) != 0)
+        prompt_IO(ERROR_IO, "[System] The file of records can't be opened.");
+
+    Replay* replay = (Replay*) malloc(sizeof(Replay));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(replay == NULL)
+        prompt_IO(ERROR_IO, "record.c, open_Replay(): malloc failed");
+    replay->size = status.st_size;
+
+    if(replay->size < sizeof(magic))
+        prompt_IO(ERROR_IO, "[System] The file isn't a file of records.");
+    void* data = mmap(NULL, replay->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays after the file is closed
+    close(fd);
+    if(data == MAP_FAILED)
+        prompt_IO(ERROR_IO, "record.c, open_Replay(): mmap failed");
+
+    replay->data = (const byte*) data;
+    if(memcmp(replay->data, magic, sizeof(magic)) != 0)
+        prompt_IO(ERROR_IO, "[System] The file isn't a file of records.");
+    replay->position = sizeof(magic);
+    return replay;
+}
+
+// Reads a varint from *p_position (which is moved past it), without going beyond 'end'. If the varint doesn't end before, notifies and aborts execution.
+static uint64_t getVarint(const byte* data, size_t* p_position, size_t end)
+{
+    uint64_t value = 0;
+    for(int shift = 0; shift < 64 && *p_position < end; shift += 7) {
+        byte b = data[(*p_position)++];
+        value |= (uint64_t) (b & 0x7F) << shift;
+        if(!(b & 0x80))
+            return value;
+    }
+
+    prompt_IO(ERROR_IO, "[System] The file of records is corrupted.");
+    return 0;
+}
+
+Game* next_Replay(Replay* replay, int* p_nr_mismatches)
+{
+    if(replay->position >= replay->size)
+        return NULL;
+
+    const byte* data = replay->data;
+    size_t length = getVarint(data, &replay->position, replay->size);
+    if(length > replay->size - replay->position)
+        prompt_IO(ERROR_IO, "[System] The file of records is corrupted.");
+    size_t position = replay->position, end = position + length;
+    replay->position = end;
+
+    // The setup
+    uint64_t seed = getVarint(data, &position, end);
+    uint64_t map_size = getVarint(data, &position, end);
+    uint64_t nr_pieces = 0, nr_per_piece[5];
+    for(int i = 0; i < 5; i++) {
+        nr_per_piece[i] = getVarint(data, &position, end);
+        nr_pieces += nr_per_piece[i];
+    }
+    uint64_t player_attacking = getVarint(data, &position, end);
+    if(map_size < 1 || map_size > 65536 || nr_pieces > MAX_PIECES_CELL || nr_pieces > map_size * map_size / 5 || player_attacking > 1)
+        prompt_IO(ERROR_IO, "[System] The file of records is corrupted.");
+
+    // The pieces of both players, the types in the order of the setup
+    Piece* pieces[2];
+    pieces[0] = (Piece*) malloc((2 * nr_pieces + 1) * sizeof(Piece));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(pieces[0] == NULL)
+        prompt_IO(ERROR_IO, "record.c, next_Replay(): malloc failed");
+    pieces[1] = pieces[0] + nr_pieces;
+
+    int64_t last_x = 0, last_y = 0;
+    for(int p = 0; p < 2; p++) {
+        int i = 0;
+        for(int type = 0; type < 5; type++) {
+            for(uint64_t j = 0; j < nr_per_piece[type]; j++, i++) {
+                uint64_t packed = getVarint(data, &position, end);
+                last_x += unzigzag(packed >> 2);
+                last_y += unzigzag(getVarint(data, &position, end));
+                update_Piece(&pieces[p][i], getType_Utils(type), (int) last_x, (int) last_y, 90 * (int) (packed & 3));
+            }
+        }
+    }
+
+    Game* game = newSetup_Game(seed, (int) map_size, (int) player_attacking, pieces, (int) nr_pieces);
+    free(pieces[0]);
+    if(game == NULL)
+        prompt_IO(ERROR_IO, "[System] The file of records is corrupted.");
+
+    // The attacks, till the end of the game
+    int64_t attack_x[2] = { 0, 0 }, attack_y[2] = { 0, 0 };
+    *p_nr_mismatches = 0;
+    while(position < end) {
+        int p = game->player_attacking;
+        uint64_t packed = getVarint(data, &position, end);
+        attack_x[p] += unzigzag(packed >> 3);
+        attack_y[p] += unzigzag(getVarint(data, &position, end));
+
+        int result = (int) (packed & 7) - 1;
+        if(attack_Game(game, (int) attack_x[p], (int) attack_y[p]) != result)
+            (*p_nr_mismatches)++;
+    }
+
+    return game;
+}
+
+void close_Replay(Replay* replay)
+{
+    munmap((void*) replay->data, replay->size);
+    free(replay);
+}
@@ -0,0 +1,81 @@
+/*
+  record.h
+  Compact binary records of games, and their replay.
+
+  A file of records starts with the 4 bytes "BSR1", followed by the games, each one as its length in bytes and then:
+    the seed, the map size, the number of pieces of each type (I, P, T, X and Z) and the first player attacking (0 or 1);
+    the pieces of the player 1 and then of the player 2, in the order they were added (by type, as on the setup), each as two numbers:
+      (x << 2) | r and y, with (x,y) the difference from the position of the previous piece (the first from (0,0)) and r the rotation (0 to 3, of 90 degrees);
+    the attacks, one player at a time, starting on the first player attacking, till the end of the game, each also as two numbers:
+      (x << 3) | (result + 1) and y, with (x,y) the difference from the previous attack of the same player (the first from (0,0)) and the result as in registerAttack_Map.
+  All the numbers are varints (7 bits per byte, the lower bits first, with the bit 7 set on all bytes but the last),
+  and the differences are zigzag encoded (n >= 0 as 2n and n < 0 as -2n - 1), so the attacks of a bot sweeping the map take 2 bytes each.
+
+  The games are replayed from the file mapped on memory, without any IO: the setup is rebuilt and the attacks played, checking their results.
+*/
+
+#ifndef RECORD_H
+#define RECORD_H
+
+#include "game.h"
+
+// Record of one game, encoded on memory while it's played, and written at once with write_Record
+typedef struct Record
+{
+    // Bytes of the game, after room for its length (RESERVED_RECORD bytes)
+    byte* bytes;
+    size_t length, capacity;
+
+    // Last attack of each player
+    int last_x[2], last_y[2];
+} Record;
+
+// Room for the length of the game, before its bytes (a varint of 64 bits)
+#define RESERVED_RECORD 10
+
+// Allocs a new record, with no game
+Record* new_Record();
+
+// Writes the start of a file of records on 'file'. If the write fails, notifies and aborts execution.
+void writeMagic_Record(FILE* file);
+
+// Starts the record of the game (anything recorded before is dropped), with its setup: the pieces of both players must be already added, and no turn played
+void start_Record(Record* record, Game* game);
+
+// Adds the attack of the player 'id_player' on (x,y), with its result (as registerAttack_Map)
+void attack_Record(Record* record, int id_player, int x, int y, int result);
+
+/*
+    Writes the game recorded on 'file' (after writeMagic_Record), with one fwrite, so many threads can write their games on the same file.
+    If the write fails, notifies and aborts execution.
+*/
+void write_Record(Record* record, FILE* file);
+
+// Frees the record
+void free_Record(Record* record);
+
+// Replay of a file of records, mapped on memory
+typedef struct Replay
+{
+    const byte* data;
+    size_t size;
+
+    // Position of the next game
+    size_t position;
+} Replay;
+
+// Maps the file of records on 'path' to replay it. If it can't be opened, or isn't a file of records, notifies and aborts execution.
+Replay* open_Replay(const char* path);
+
+/*
+    Rebuilds the next game of the replay, with its setup and all its attacks played (without any IO),
+    and writes on *p_nr_mismatches the number of attacks whose result isn't the one recorded.
+    Returns the game (to be freed with free_Game), or NULL if there are no more games.
+    If the game is corrupted, notifies and aborts execution.
+*/
+Game* next_Replay(Replay* replay, int* p_nr_mismatches);
+
+// Unmaps the file and frees the replay
+void close_Replay(Replay* replay);
+
+#endif
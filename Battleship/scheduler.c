@@ -0,0 +1,163 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "scheduler.h"
+
+#include "utils.h"
+#include "io.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+// Range of tasks of a thread, from 'next' to 'end' - 1
+typedef struct Worker
+{
+    pthread_mutex_t lock;
+    int next, end;
+
+    // Thread number of the worker
+    int id;
+    pthread_t thread;
+    struct Scheduler* scheduler;
+} Worker;
+
+// Definition of the scheduler
+typedef struct Scheduler
+{
+    Worker* workers;
+    int nr_threads;
+
+    Task task;
+    void* context;
+} Scheduler;
+
+// Returns the number of tasks left on the range of the worker
+static int tasksLeft(Worker* worker)
+{
+    pthread_mutex_lock(&worker->lock);
+    int left = worker->end - worker->next;
+    pthread_mutex_unlock(&worker->lock);
+    return left;
+}
+
+// Takes the next task of the range of the worker. Returns false if the range is empty.
+static bool takeTask(Worker* worker, int* p_task)
+{
+    pthread_mutex_lock(&worker->lock);
+    bool taken = worker->next < worker->end;
+    if(taken)
+        *p_task = worker->next++;
+    pthread_mutex_unlock(&worker->lock);
+    return taken;
+}
+
+/*
+    Steals, for the worker, the second half of the range of the worker with the most tasks left.
+    Returns false if no worker had tasks left.
+*/
+static bool stealTasks(Worker* worker)
+{
+    Scheduler* scheduler = worker->scheduler;
+
+    for(;;) {
+        // The ranges may change after being seen, so the range of the victim is checked again, when taking half of it
+        Worker* victim = NULL;
+        int most_left = 0;
+        for(int i = 0; i < scheduler->nr_threads; i++) {
+            Worker* other = &scheduler->workers[i];
+            if(other == worker)
+                continue;
+            int left = tasksLeft(other);
+            if(left > most_left) {
+                victim = other;
+                most_left = left;
+            }
+        }
+        if(victim == NULL)
+            return false;
+
+        int begin = 0, end = 0;
+        pthread_mutex_lock(&victim->lock);
+        int left = victim->end - victim->next;
+        if(left > 0) {
+            end = victim->end;
+            begin = victim->end - (left + 1) / 2;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if(begin < end) {
+            pthread_mutex_lock(&worker->lock);
+            worker->next = begin;
+            worker->end = end;
+            pthread_mutex_unlock(&worker->lock);
+            return true;
+        }
+    }
+}
+
+// Function of each thread: runs the tasks of its range, then steals more, till there are none left
+static void* work(void* argument)
+{
+    Worker* worker = (Worker*) argument;
+    Scheduler* scheduler = worker->scheduler;
+
+    int task;
+    do {
+        while(takeTask(worker, &task))
+            scheduler->task(task, worker->id, scheduler->context);
+    } while(stealTasks(worker));
+
+    return NULL;
+}
+
+int processors_Scheduler()
+{
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? (int) processors : 1;
+}
+
+double now_Scheduler()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+void run_Scheduler(int nr_tasks, int nr_threads, Task task, void* context)
+{
+    // Case there are no threads, notify and abort execution
+    if(nr_threads <= 0)
+        prompt_IO(ERROR_IO, "scheduler.c, run_Scheduler(): invalid number of threads");
+
+    Scheduler scheduler;
+    scheduler.nr_threads = nr_threads;
+    scheduler.task = task;
+    scheduler.context = context;
+    scheduler.workers = (Worker*) malloc(nr_threads * sizeof(Worker));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(scheduler.workers == NULL)
+        prompt_IO(ERROR_IO, "scheduler.c, run_Scheduler(): malloc failed");
+
+    // Equal ranges, one per thread
+    for(int i = 0; i < nr_threads; i++) {
+        Worker* worker = &scheduler.workers[i];
+        pthread_mutex_init(&worker->lock, NULL);
+        worker->next = (int) ((long) nr_tasks * i / nr_threads);
+        worker->end = (int) ((long) nr_tasks * (i + 1) / nr_threads);
+        worker->id = i;
+        worker->scheduler = &scheduler;
+    }
+
+    // The thread 0 is the one calling
+    for(int i = 1; i < nr_threads; i++)
+        if(pthread_create(&scheduler.workers[i].thread, NULL, work, &scheduler.workers[i]) != 0)
+            prompt_IO(ERROR_IO, "scheduler.c, run_Scheduler(): pthread_create failed");
+    work(&scheduler.workers[0]);
+    for(int i = 1; i < nr_threads; i++)
+        pthread_join(scheduler.workers[i].thread, NULL);
+
+    for(int i = 0; i < nr_threads; i++)
+        pthread_mutex_destroy(&scheduler.workers[i].lock);
+    free(scheduler.workers);
+}
@@ -0,0 +1,25 @@
+/*
+  scheduler.h
+  Runs a number of independent tasks over a number of threads, with work stealing.
+
+  The tasks (numbered from 0) start split in equal ranges, one per thread, and each thread runs the tasks of its range, in order.
+  When a thread runs out of tasks, it steals the second half of the range of the thread with the most tasks left,
+  so all the threads are kept busy till the end, even when the tasks take very different times.
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// Function that runs the task number 'task', on the thread number 'thread' (0 to the number of threads - 1)
+typedef void (*Task)(int task, int thread, void* context);
+
+// Returns the number of processors online (at least 1)
+int processors_Scheduler();
+
+// Returns the time, in seconds, of a monotonic clock (to time the tasks, and the budgets of the bots)
+double now_Scheduler();
+
+// Runs the tasks 0 to nr_tasks - 1, each with task(task, thread, context), over nr_threads threads, and returns when all are done
+void run_Scheduler(int nr_tasks, int nr_threads, Task task, void* context);
+
+#endif
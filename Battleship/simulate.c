@@ -0,0 +1,315 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "game.h"
+
+#include "bot.h"
+#include "density.h"
+#include "montecarlo.h"
+#include "scheduler.h"
+#include "options.h"
+#include "record.h"
+#include "io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+    Plays games where both players are bots, without any IO, over all the processors, and prints statistics of the games.
+    Options:
+        --games <n>     number of games (default 1000)
+        --threads <n>   number of threads (default, the number of processors)
+        --seed <n>      seed of the first game, the game number i gets the seed + i (default, based on the current time)
+        --map <name>    backend of the maps (as in the game)
+        --histogram 1   also prints how many games were won in each number of turns
+        --player1 <bot> bot of the player 1: 'random' (attacks random cells, the default), 'density' (see density.h) or 'montecarlo' (see montecarlo.h)
+        --player2 <bot> bot of the player 2, as the player 1
+        --budget <n>    time budget of each attack of the bot 'montecarlo', in microseconds (default 500)
+        --fleets <n>    least number of fleets drawn on each attack of the bot 'montecarlo' (default 0; with --budget 0, the games don't depend on the time)
+        --record <file> records all the games on the file (see record.h), in the order they end
+        --replay <file> instead of playing, replays the games recorded on the file, checking the result of each attack, and prints how fast they were replayed
+    The bot 'montecarlo' draws its fleets on one thread, since the games already run on all the processors.
+    The games only depend on their seed, so the same seed gives the same statistics (except the timings), with any number of threads.
+*/
+
+// Max number of turns of the winner: he attacks each cell of the biggest map once, at most
+#define MAX_TURNS (40 * 40)
+
+// Statistics of the games played by one thread
+typedef struct Stats
+{
+    long nr_games;
+    long wins[2];
+
+    // Seconds spent on each phase of the games: setup (game and bots allocated), play (all the turns) and free
+    double setup, play, free;
+
+    // Number of games won in each number of turns of the winner
+    long turns_to_win[MAX_TURNS + 1];
+} Stats;
+
+// Kind of bot: how it's allocated (to attack the map of the other player), its attacker and how it's freed
+typedef struct Kind
+{
+    const char* name;
+    void* (*newBot)(Game* game, int id_player);
+    Attacker attack;
+    void (*freeBot)(void* bot);
+} Kind;
+
+static void* newRandom(Game* game, int id_player)
+{
+    return new_Bot(game->players[(id_player + 1) % 2]->map->size, &game->random);
+}
+
+static void freeRandom(void* bot)
+{
+    free_Bot((Bot*) bot);
+}
+
+static void* newDensity(Game* game, int id_player)
+{
+    return new_Density(game->players[(id_player + 1) % 2], &game->random);
+}
+
+static void freeDensity(void* bot)
+{
+    free_Density((Density*) bot);
+}
+
+// Time budget, in seconds, and least number of fleets of each attack of the bot 'montecarlo' (given by the options)
+static double budget;
+static int min_fleets;
+
+static void* newMonteCarlo(Game* game, int id_player)
+{
+    return new_MonteCarlo(game->players[(id_player + 1) % 2], &game->random, 1, budget, min_fleets);
+}
+
+static void freeMonteCarlo(void* bot)
+{
+    free_MonteCarlo((MonteCarlo*) bot);
+}
+
+static Kind kinds[] = {
+    { "random", newRandom, attack_Bot, freeRandom },
+    { "density", newDensity, attack_Density, freeDensity },
+    { "montecarlo", newMonteCarlo, attack_MonteCarlo, freeMonteCarlo }
+};
+
+// Returns the kind of bot of the option 'name' (the first kind, if it isn't given). If there's no such kind, notifies and aborts execution.
+static Kind* chooseKind(int argc, char* argv[], const char* name)
+{
+    const char* value = get_Options(argc, argv, name, NULL);
+    if(value == NULL)
+        return &kinds[0];
+
+    for(int i = 0; i < (int) (sizeof(kinds) / sizeof(kinds[0])); i++)
+        if(strcmp(kinds[i].name, value) == 0)
+            return &kinds[i];
+
+    prompt_IO(ERROR_IO, "[System] Unknown bot. The bots are 'random', 'density' and 'montecarlo'.");
+    return NULL;
+}
+
+// Context of the tasks: one game per task
+typedef struct Simulation
+{
+    uint64_t seed;
+    Kind* kinds[2];
+    Stats* stats;
+
+    // File where the games are recorded, and the record of each thread (NULL if the games aren't recorded)
+    FILE* record_file;
+    Record** records;
+} Simulation;
+
+// Task that plays the game number 'task', on the thread 'thread'
+static void playGame(int task, int thread, void* context)
+{
+    Simulation* simulation = (Simulation*) context;
+    Stats* stats = &simulation->stats[thread];
+
+    double start = now_Scheduler();
+    Game* game = newHeadless_Game(simulation->seed + task);
+    void* bots[2];
+    for(int p = 0; p < 2; p++) {
+        // The bot p attacks the map of the other player
+        bots[p] = simulation->kinds[p]->newBot(game, p);
+        setAttacker_Game(game, p, simulation->kinds[p]->attack, bots[p]);
+    }
+    if(simulation->records != NULL)
+        setRecord_Game(game, simulation->records[thread]);
+
+    double setup_end = now_Scheduler();
+    do
+        playTurn_Game(game);
+    while(!over_Game(game));
+
+    // The winner is the player that made the last attack, so he made half of the turns, rounded up
+    double play_end = now_Scheduler();
+    if(simulation->records != NULL)
+        write_Record(simulation->records[thread], simulation->record_file);
+    int winner = (game->player_attacking + 1) % 2;
+    int turns = (game->turns + 1) / 2;
+
+    for(int p = 0; p < 2; p++)
+        simulation->kinds[p]->freeBot(bots[p]);
+    free_Game(game);
+    double end = now_Scheduler();
+
+    stats->nr_games++;
+    stats->wins[winner]++;
+    stats->turns_to_win[turns <= MAX_TURNS ? turns : MAX_TURNS]++;
+    stats->setup += setup_end - start;
+    stats->play += play_end - setup_end;
+    stats->free += end - play_end;
+}
+
+// Returns the least number of turns, where at least 'fraction' of the games were won
+static int percentile(Stats* total, double fraction)
+{
+    long wanted = (long) (fraction * total->nr_games + 0.5), count = 0;
+    if(wanted < 1)
+        wanted = 1;
+    for(int turns = 0; turns <= MAX_TURNS; turns++) {
+        count += total->turns_to_win[turns];
+        if(count >= wanted)
+            return turns;
+    }
+    return MAX_TURNS;
+}
+
+// Prints the statistics of all the games
+static void printStats(Stats* total, Simulation* simulation, int nr_threads, double seconds, bool histogram)
+{
+    double turns_sum = 0;
+    for(int turns = 0; turns <= MAX_TURNS; turns++)
+        turns_sum += (double) turns * total->turns_to_win[turns];
+    double phases = total->setup + total->play + total->free;
+
+    printf("games: %ld\n", total->nr_games);
+    printf("threads: %d\n", nr_threads);
+    printf("seed: %llu\n", (unsigned long long) simulation->seed);
+    printf("backend: %s\n", getBackend_Map());
+    printf("bots: player1 %s, player2 %s\n", simulation->kinds[0]->name, simulation->kinds[1]->name);
+    printf("seconds: %.3f\n", seconds);
+    printf("games/sec: %.1f\n", total->nr_games / seconds);
+    printf("wins: player1 %ld, player2 %ld\n", total->wins[0], total->wins[1]);
+    printf("turns to win: mean %.1f, min %d, p10 %d, p50 %d, p90 %d, p99 %d, max %d\n", turns_sum / total->nr_games,
+           percentile(total, 0), percentile(total, 0.1), percentile(total, 0.5), percentile(total, 0.9), percentile(total, 0.99), percentile(total, 1));
+    printf("phase setup: %.1f us/game (%.1f%%)\n", 1e6 * total->setup / total->nr_games, 100 * total->setup / phases);
+    printf("phase play: %.1f us/game (%.1f%%)\n", 1e6 * total->play / total->nr_games, 100 * total->play / phases);
+    printf("phase free: %.1f us/game (%.1f%%)\n", 1e6 * total->free / total->nr_games, 100 * total->free / phases);
+
+    if(histogram)
+        for(int turns = 0; turns <= MAX_TURNS; turns++)
+            if(total->turns_to_win[turns] != 0)
+                printf("turns %d: %ld\n", turns, total->turns_to_win[turns]);
+}
+
+// Replays all the games of the file of records on 'path', and prints how many, how fast, and the attacks whose result isn't the one recorded
+static void replay(const char* path)
+{
+    double start = now_Scheduler();
+    Replay* replay = open_Replay(path);
+
+    long nr_games = 0, nr_attacks = 0, nr_mismatches = 0, wins[2] = { 0, 0 };
+    int mismatches;
+    Game* game;
+    while((game = next_Replay(replay, &mismatches)) != NULL) {
+        nr_games++;
+        nr_attacks += game->turns;
+        nr_mismatches += mismatches;
+        // The winner made the last attack (if the game was played till the end)
+        if(game->players[game->player_attacking]->hp == 0)
+            wins[(game->player_attacking + 1) % 2]++;
+        free_Game(game);
+    }
+
+    close_Replay(replay);
+    double seconds = now_Scheduler() - start;
+    printf("games: %ld\n", nr_games);
+    printf("backend: %s\n", getBackend_Map());
+    printf("attacks: %ld\n", nr_attacks);
+    printf("mismatches: %ld\n", nr_mismatches);
+    printf("wins: player1 %ld, player2 %ld\n", wins[0], wins[1]);
+    printf("seconds: %.3f\n", seconds);
+    printf("games/sec: %.1f\n", nr_games / seconds);
+    printf("attacks/sec: %.1f\n", nr_attacks / seconds);
+}
+
+int main(int argc, char* argv[])
+{
+    chooseBackend_Options(argc, argv);
+    const char* replay_path = get_Options(argc, argv, "replay", NULL);
+    if(replay_path != NULL) {
+        replay(replay_path);
+        return 0;
+    }
+
+    int nr_games = (int) getNumber_Options(argc, argv, "games", NULL, 1000);
+    int nr_threads = (int) getNumber_Options(argc, argv, "threads", NULL, processors_Scheduler());
+    uint64_t seed = getNumber_Options(argc, argv, "seed", "BATTLESHIP_SEED", (uint64_t) time(NULL));
+    bool histogram = getNumber_Options(argc, argv, "histogram", NULL, 0) != 0;
+    budget = getNumber_Options(argc, argv, "budget", NULL, 500) * 1e-6;
+    min_fleets = (int) getNumber_Options(argc, argv, "fleets", NULL, 0);
+
+    if(nr_games <= 0 || nr_threads <= 0)
+        prompt_IO(ERROR_IO, "[System] The number of games and of threads must be positive.");
+
+    Simulation simulation;
+    simulation.seed = seed;
+    simulation.kinds[0] = chooseKind(argc, argv, "player1");
+    simulation.kinds[1] = chooseKind(argc, argv, "player2");
+    simulation.stats = (Stats*) calloc(nr_threads, sizeof(Stats));
+    // Case calloc failed, print that calloc failed and abort execution
+    if(simulation.stats == NULL)
+        prompt_IO(ERROR_IO, "simulate.c, main(): calloc failed");
+
+    const char* record_path = get_Options(argc, argv, "record", NULL);
+    simulation.record_file = NULL;
+    simulation.records = NULL;
+    if(record_path != NULL) {
+        simulation.record_file = fopen(record_path, "wb");
+        simulation.records = (Record**) malloc(nr_threads * sizeof(Record*));
+        if(simulation.record_file == NULL || simulation.records == NULL)
+            prompt_IO(ERROR_IO, "[System] The file of records can't be opened.");
+        writeMagic_Record(simulation.record_file);
+        for(int t = 0; t < nr_threads; t++)
+            simulation.records[t] = new_Record();
+    }
+
+    double start = now_Scheduler();
+    run_Scheduler(nr_games, nr_threads, playGame, &simulation);
+    double seconds = now_Scheduler() - start;
+
+    if(simulation.records != NULL) {
+        for(int t = 0; t < nr_threads; t++)
+            free_Record(simulation.records[t]);
+        free(simulation.records);
+        fclose(simulation.record_file);
+    }
+
+    // Sum the statistics of all the threads
+    Stats* total = (Stats*) calloc(1, sizeof(Stats));
+    if(total == NULL)
+        prompt_IO(ERROR_IO, "simulate.c, main(): calloc failed");
+    for(int t = 0; t < nr_threads; t++) {
+        Stats* stats = &simulation.stats[t];
+        total->nr_games += stats->nr_games;
+        total->wins[0] += stats->wins[0];
+        total->wins[1] += stats->wins[1];
+        total->setup += stats->setup;
+        total->play += stats->play;
+        total->free += stats->free;
+        for(int turns = 0; turns <= MAX_TURNS; turns++)
+            total->turns_to_win[turns] += stats->turns_to_win[turns];
+    }
+
+    printStats(total, &simulation, nr_threads, seconds, histogram);
+
+    free(total);
+    free(simulation.stats);
+    return 0;
+}
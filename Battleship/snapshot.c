@@ -0,0 +1,210 @@
+#include "snapshot.h"
+
+#include "utils.h"
+#include "io.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Start of a snapshot
+static const byte magic[4] = { 'B', 'S', 'S', '1' };
+
+// Header of a snapshot (the fields are ordered by width, with the room left explicit, so the compiler adds no padding and all its bytes are written)
+typedef struct SnapshotHeader
+{
+    byte magic[4];
+    uint32_t reserved;
+    uint64_t size;
+    uint64_t seed;
+    uint64_t random[4];
+    int32_t map_size, player_attacking, turns;
+    int32_t nr_pieces[2], hp[2];
+    int32_t padding;
+} SnapshotHeader;
+
+// Piece of a snapshot, as the masks of piece.h
+typedef struct SnapshotPiece
+{
+    int32_t type, posX, posY;
+    uint32_t shape, hits;
+} SnapshotPiece;
+
+// Returns the size of a snapshot with maps of map_size * map_size and 'nr_pieces' pieces on both players
+static uint64_t sizeOf(uint64_t map_size, uint64_t nr_pieces)
+{
+    return sizeof(SnapshotHeader) + 2 * nr_pieces * sizeof(SnapshotPiece) + 2 * map_size * map_size;
+}
+
+size_t size_Snapshot(Game* game)
+{
+    return sizeOf(game->players[0]->map->size, game->players[0]->nr_pieces);
+}
+
+// Returns true if 'shape' is the format of the type on some rotation
+static bool validShape(char type, uint32_t shape)
+{
+    for(int r = 0; r < 4; r++)
+        if(getMask_BitMap(type, 90 * r) == shape)
+            return true;
+    return false;
+}
+
+void save_Snapshot(Game* game, void* blob)
+{
+    // Both players have the same setup, so the maps have the same size and the players the same number of pieces
+    int size = game->players[0]->map->size;
+    if(game->players[1]->nr_pieces != game->players[0]->nr_pieces)
+        prompt_IO(ERROR_IO, "snapshot.c, save_Snapshot(): the players have different setups");
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.size = size_Snapshot(game);
+    header.seed = game->seed;
+    memcpy(header.random, game->random.state, sizeof(header.random));
+    header.map_size = size;
+    header.player_attacking = game->player_attacking;
+    header.turns = game->turns;
+    for(int p = 0; p < 2; p++) {
+        header.nr_pieces[p] = game->players[p]->nr_pieces;
+        header.hp[p] = game->players[p]->hp;
+    }
+
+    byte* out = (byte*) blob;
+    memcpy(out, &header, sizeof(header));
+    byte* pieces = out + sizeof(header);
+    byte* shots = pieces + 2 * (size_t) header.nr_pieces[0] * sizeof(SnapshotPiece);
+
+    for(int p = 0; p < 2; p++) {
+        Player* player = game->players[p];
+        byte* rows = shots + (size_t) p * size * size;
+
+        for(int i = 0; i < player->nr_pieces; i++) {
+            Piece* piece = &player->pieces[i];
+            SnapshotPiece saved = { piece->type, piece->posX, piece->posY, piece->shape, piece->hits };
+            memcpy(pieces, &saved, sizeof(saved));
+            pieces += sizeof(saved);
+        }
+
+        exportRows_Map(player->map, rows, false);
+    }
+}
+
+Game* restore_Snapshot(const void* blob, size_t size)
+{
+    const byte* in = (const byte*) blob;
+    SnapshotHeader header;
+    if(size < sizeof(header))
+        return NULL;
+    memcpy(&header, in, sizeof(header));
+
+    if(memcmp(header.magic, magic, sizeof(magic)) != 0 || header.size != size || header.map_size < 1 || header.map_size > 65536
+       || header.player_attacking < 0 || header.player_attacking > 1 || header.turns < 0 || header.nr_pieces[0] != header.nr_pieces[1]
+       || header.nr_pieces[0] < 0 || header.nr_pieces[0] > MAX_PIECES_CELL || sizeOf(header.map_size, header.nr_pieces[0]) != size)
+        return NULL;
+    int map_size = header.map_size, nr_pieces = header.nr_pieces[0];
+    const byte* shots = in + sizeof(header) + 2 * (size_t) nr_pieces * sizeof(SnapshotPiece);
+
+    // The pieces of both players are added without hits, and hitted again after, so the maps and the hp are the ones of the attacks
+    Piece* pieces[2];
+    uint32_t* hits = (uint32_t*) malloc((2 * nr_pieces + 1) * sizeof(uint32_t));
+    pieces[0] = (Piece*) malloc((2 * nr_pieces + 1) * sizeof(Piece));
+    // Case malloc failed, print that malloc failed and abort execution
+    if(pieces[0] == NULL || hits == NULL)
+        prompt_IO(ERROR_IO, "snapshot.c, restore_Snapshot(): malloc failed");
+    pieces[1] = pieces[0] + nr_pieces;
+
+    const byte* p_piece = in + sizeof(header);
+    bool valid = true;
+    for(int i = 0; i < 2 * nr_pieces && valid; i++) {
+        SnapshotPiece saved;
+        memcpy(&saved, p_piece, sizeof(saved));
+        p_piece += sizeof(saved);
+
+        valid = saved.type == (char) saved.type && isType_Utils((char) saved.type) && validShape((char) saved.type, saved.shape) && (saved.hits & ~saved.shape) == 0;
+        Piece* piece = &pieces[0][i];
+        piece->type = (char) saved.type;
+        piece->posX = saved.posX;
+        piece->posY = saved.posY;
+        piece->shape = saved.shape;
+        piece->hits = 0;
+        hits[i] = saved.hits;
+    }
+
+    Game* game = valid ? newSetup_Game(header.seed, map_size, header.player_attacking, pieces, nr_pieces) : NULL;
+    free(pieces[0]);
+    if(game == NULL) {
+        free(hits);
+        return NULL;
+    }
+    memcpy(game->random.state, header.random, sizeof(header.random));
+    game->turns = header.turns;
+
+    for(int p = 0; p < 2 && valid; p++) {
+        Player* player = game->players[p];
+        for(int i = 0; i < nr_pieces; i++) {
+            Piece* piece = &player->pieces[i];
+            for(int k = 0; k < 25; k++)
+                if(hits[p * nr_pieces + i] >> k & 1)
+                    registerAttack_Player(player, piece->posX - 2 + k / 5, piece->posY - 2 + k % 5);
+        }
+
+        // Only the cells with shots are registered (on most maps, the others aren't even stored)
+        const byte* rows = shots + (size_t) p * map_size * map_size;
+        for(int x = 0; x < map_size && valid; x++)
+            for(int y = 0; y < map_size; y++) {
+                byte b = rows[(size_t) x * map_size + y];
+                if(b > 6)
+                    valid = false;
+                else if(b != 0)
+                    registerShot_Map(player->map, x, y, b);
+            }
+
+        valid = valid && player->hp == header.hp[p];
+    }
+
+    free(hits);
+    if(!valid) {
+        free_Game(game);
+        return NULL;
+    }
+    return game;
+}
+
+void write_Snapshot(Game* game, FILE* file)
+{
+    size_t size = size_Snapshot(game);
+    void* blob = malloc(size);
+    // Case malloc failed, print that malloc failed and abort execution
+    if(blob == NULL)
+        prompt_IO(ERROR_IO, "snapshot.c, write_Snapshot(): malloc failed");
+
+    save_Snapshot(game, blob);
+    // Case the write failed, print that the write failed and abort execution
+    if(fwrite(blob, 1, size, file) != size)
+        prompt_IO(ERROR_IO, "snapshot.c, write_Snapshot(): write failed");
+    free(blob);
+}
+
+Game* load_Snapshot(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == NULL || fseek(file, 0, SEEK_END) != 0)
+        prompt_IO(ERROR_IO, "[System] The snapshot can't be opened.");
+    long size = ftell(file);
+    if(size < 0 || fseek(file, 0, SEEK_SET) != 0)
+        prompt_IO(ERROR_IO, "[System] The snapshot can't be opened.");
+
+    void* blob = malloc(size > 0 ? size : 1);
+    // Case malloc failed, print that malloc failed and abort execution
+    if(blob == NULL)
+        prompt_IO(ERROR_IO, "snapshot.c, load_Snapshot(): malloc failed");
+    if(fread(blob, 1, size, file) != (size_t) size)
+        prompt_IO(ERROR_IO, "[System] The snapshot can't be read.");
+    fclose(file);
+
+    Game* game = restore_Snapshot(blob, size);
+    free(blob);
+    if(game == NULL)
+        prompt_IO(ERROR_IO, "[System] The file isn't a valid snapshot.");
+    return game;
+}
@@ -0,0 +1,40 @@
+/*
+  snapshot.h
+  Snapshots of a game in progress: the whole state of the game in one flat block of bytes, and the game rebuilt from it.
+
+  A snapshot has no pointers (so it can be written to a file, or copied to other processes or threads, and read anywhere) and its parts are at fixed places:
+    the header: the 4 bytes "BSS1", the size of the snapshot, the seed and the state of the generator of the game,
+      the map size, the player attacking, the turns played, and the number of pieces and the hp of each player;
+    the pieces of the player 1 and then of the player 2, in the order they were added, each as its type, position, format and hits (the masks of piece.h);
+    the shots of the player 1 and then of the player 2, one byte per cell, the cell (x,y) on x * size + y (as exportRows_Map).
+  The numbers are of fixed width, in the byte order of the machine.
+
+  The game is rebuilt from the snapshot with one pass over it, without any IO: the pieces are added, their hits attacked again and the shots registered.
+  The snapshot doesn't depend on the map used (see map.h), so it can be restored with another one.
+  The attackers, the sink, the source and the record of the game aren't part of the snapshot.
+*/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "game.h"
+
+// Returns the size, in bytes, of the snapshot of the game
+size_t size_Snapshot(Game* game);
+
+// Writes the snapshot of the game on 'blob', with room for size_Snapshot bytes. The game must be between turns (not on its setup).
+void save_Snapshot(Game* game, void* blob);
+
+/*
+    Rebuilds the game of the snapshot on 'blob', with 'size' bytes, without any IO (as newSetup_Game, so the attackers must be set before playing).
+    Returns the game (to be freed with free_Game), or NULL if the bytes aren't a valid snapshot (and nothing stays allocated).
+*/
+Game* restore_Snapshot(const void* blob, size_t size);
+
+// Writes the snapshot of the game on 'file', with one fwrite. If the write fails, notifies and aborts execution.
+void write_Snapshot(Game* game, FILE* file);
+
+// Rebuilds the game of the snapshot on the file on 'path', read with one read. If it can't be read, or isn't a snapshot, notifies and aborts execution.
+Game* load_Snapshot(const char* path);
+
+#endif
@@ -17,6 +17,29 @@ char getType_Utils(int type)
     return 0;
 }
 
+int getTypeIndex_Utils(char type)
+{
+    switch(type) {
+        case 'I': return 0;
+        case 'P': return 1;
+        case 'T': return 2;
+        case 'X': return 3;
+        case 'Z': return 4;
+        default: prompt_IO(ERROR_IO, "utils.c, getTypeIndex_Utils(): invalid type"); break;
+    }
+
+    // unreachable statement (Since, if it gets to the default case, the execution is aborted). Just to shutdown warning.
+    return 0;
+}
+
+bool isType_Utils(char type)
+{
+    for(int i = 0; i < 5; i++)
+        if(getType_Utils(i) == type)
+            return true;
+    return false;
+}
+
 int abs(int n) {
     if(n < 0) return -n;
     return n;
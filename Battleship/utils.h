@@ -29,6 +29,12 @@ typedef unsigned char byte;
 */
 char getType_Utils(int type);
 
+// Inverse of getType_Utils: returns the int (0 to 4) of a type of a piece. Given an invalid type, notifies and aborts execution.
+int getTypeIndex_Utils(char type);
+
+// Returns true if 'type' is one of the types of pieces (those of getType_Utils), otherwise returns false.
+bool isType_Utils(char type);
+
 // Returns the absolute value of a number
 int abs(int n);
 